@@ -0,0 +1,475 @@
+#ifndef __ENGINE_H
+#define __ENGINE_H
+
+#include <stdint.h>
+
+/* ***************   BOARD GEOMETRY   *************** */
+/* The size of the board is fixed at compile time (-DBOARD_DIMENSION=9 for the
+	 standard 9x9 board with 10 walls for each player): masks, tables and loops
+	 below are all derived from it, so each size gets its own constant code. */
+#ifndef BOARD_DIMENSION
+#define BOARD_DIMENSION 7		/* SQUARES ON A ROW (AND ON A COLUMN) */
+#endif
+#if BOARD_DIMENSION < 3 || BOARD_DIMENSION > 9
+#error "BOARD_DIMENSION must be from 3 to 9 (a game record byte holds up to 9x9 moves)"
+#endif
+#ifndef WALLS_PER_PLAYER
+#if BOARD_DIMENSION == 9
+#define WALLS_PER_PLAYER 10
+#else
+#define WALLS_PER_PLAYER 8
+#endif
+#endif
+#define BOARD_DIM (2 * BOARD_DIMENSION - 1)	/* SQUARES + SPACES. SIZE OF THE LEGACY VIEW (13x13 ON 7x7) */
+#define BOARD_SQUARES (BOARD_DIMENSION * BOARD_DIMENSION)
+#define WALL_DIMENSION (BOARD_DIMENSION - 1)	/* WALL SLOTS ON A ROW (AND ON A COLUMN) */
+
+/* A square is identified by row*7 + col (0 to 48 on 7x7). A wall slot is identified by the square
+	 on the top-left of its center, so it uses the same indexing (row and col from 0 to 5). */
+#define SQUARE(row, col) ((row) * BOARD_DIMENSION + (col))
+#define SLOT(row, col) SQUARE(row, col)
+#define ROW_OF(sq) ((sq) / BOARD_DIMENSION)
+#define COL_OF(sq) ((sq) % BOARD_DIMENSION)
+#define NO_SQUARE (-1)
+
+/* MASK OF SQUARES OR SLOTS, ONE BIT EACH: 64 BITS UP TO 7x7, 128 BITS (GCC, HOST ONLY) ABOVE */
+#if BOARD_SQUARES < 64
+typedef uint64_t Bits;
+#else
+__extension__ typedef unsigned __int128 Bits;
+#endif
+#define BIT(i) ((Bits) 1 << (i))
+
+#define ROW_FIRST (BIT(BOARD_DIMENSION) - 1)												/* SQUARES OF ROW 0 */
+#define ROW_LAST (ROW_FIRST << (BOARD_SQUARES - BOARD_DIMENSION))	/* SQUARES OF THE LAST ROW */
+#define COL_FIRST ((BIT(BOARD_SQUARES) - 1) / ROW_FIRST)					/* SQUARES OF COLUMN 0 */
+#define COL_LAST (COL_FIRST << (BOARD_DIMENSION - 1))							/* SQUARES OF THE LAST COLUMN */
+#define SQUARES_MASK (BIT(BOARD_SQUARES) - 1)
+#define SLOTS_MASK (SQUARES_MASK & ~ROW_LAST & ~COL_LAST)	/* VALID WALL SLOTS (36 ON 7x7) */
+
+/* DIRECTIONS, IN THE SAME ORDER USED BY possible_moves */
+#define DIR_DOWN 0
+#define DIR_LEFT 1
+#define DIR_RIGHT 2
+#define DIR_UP 3
+
+/**
+ * @brief Bitboard representation of a Quoridor position.
+ *
+ * @details Tokens are kept as square indexes. Walls are kept as two masks
+ * (Bits) of occupied slots, one per orientation, plus the subset placed by
+ * player 2 (the legacy view distinguishes 3 and 4). 'block_s' and 'block_e'
+ * are derived from the walls: bit sq is set if the step from sq to the square
+ * below (sq+7) or on the right (sq+1) is closed by a wall. 'free_h' and
+ * 'free_v' are the slots where a wall of each orientation would neither
+ * overlap nor cross the walls on the board (traps not considered). 'key' is the
+ * Zobrist key of tokens, walls and walls left (see hash.c), kept up to date by
+ * every function that changes the board.
+ */
+typedef struct {
+	int pawn[2];						/* SQUARE OF PLAYER1 AND PLAYER2 */
+	int walls[2];						/* WALLS STILL AVAILABLE FOR PLAYER1 AND PLAYER2 */
+	Bits wall_h, wall_v;				/* OCCUPIED SLOTS, HORIZONTAL AND VERTICAL WALLS */
+	Bits owner_h, owner_v;			/* SLOTS OCCUPIED BY WALLS OF PLAYER2 */
+	Bits block_s, block_e;			/* CLOSED STEPS DOWN AND RIGHT */
+	Bits free_h, free_v;				/* SLOTS STILL FREE FOR AN HORIZONTAL AND A VERTICAL WALL */
+	uint64_t key;								/* ZOBRIST KEY (SIDE TO MOVE NOT INCLUDED) */
+} Board;
+
+/**
+ * @brief Cache of the shortest path of each player to its goal row.
+ *
+ * @details 'dist' holds, for every square, the number of steps needed to reach
+ * the goal row (tokens never block a path). A wall recomputes only the region
+ * behind it, where distances can grow, and only when needed: at once for a
+ * player whose path it cuts, otherwise it is noted in 'stale_h'/'stale_v'
+ * until the distances are read (path_cache_dist). 'path_s' and 'path_e' hold
+ * the steps of one shortest path from the token, in the same format of
+ * 'block_s' and 'block_e'. A wall that closes none of these steps cannot trap
+ * the player, so most trap checks end without any search. The cache must be told of every
+ * change of the board (path_cache_init, path_cache_place_wall, path_cache_move_pawn).
+ */
+typedef struct {
+	uint8_t dist[2][BOARD_SQUARES];		/* DISTANCES TO GOAL ROW 6 (PLAYER1) AND ROW 0 (PLAYER2) */
+	Bits stale_h[2], stale_v[2];			/* SLOTS OF THE WALLS NOT YET IN dist */
+	Bits path_s[2], path_e[2];				/* STEPS DOWN/RIGHT OF THE CURRENT SHORTEST PATHS */
+	int length[2];										/* LENGTH OF THE CURRENT SHORTEST PATHS */
+	uint32_t hits, misses;						/* TRAP CHECKS WITHOUT / WITH A FLOOD FILL */
+} PathCache;
+
+#define PATH_UNREACHABLE 0xFF
+
+/* A move is a 32-bit word with the same layout of 'mossa':
+		[31:24] player (0 for player1, 1 for player2)
+		[23:20] 0 if the token moves, 1 if a wall is placed
+		[19:16] 0 if the wall is vertical, 1 if horizontal (0 for tokens)
+		[15:8]  row (Y) of the destination square or of the wall slot
+		[7:0]   column (X) of the destination square or of the wall slot */
+typedef uint32_t Move;
+
+#define MOVE_PAWN(id_player, sq) \
+	((Move) ((id_player) - 1) << 24 | (Move) ROW_OF(sq) << 8 | (Move) COL_OF(sq))
+#define MOVE_WALL(id_player, horizontal, slot) \
+	((Move) ((id_player) - 1) << 24 | (Move) 1 << 20 | (Move) (horizontal) << 16 | (Move) ROW_OF(slot) << 8 | (Move) COL_OF(slot))
+#define MOVE_PLAYER(m) ((int) ((m) >> 24 & 0xFF) + 1)
+#define MOVE_IS_WALL(m) ((int) ((m) >> 20 & 0xF))
+#define MOVE_HORIZONTAL(m) ((int) ((m) >> 16 & 0xF))
+#define MOVE_Y(m) ((int) ((m) >> 8 & 0xFF))
+#define MOVE_X(m) ((int) ((m) & 0xFF))
+#define MOVE_SQUARE(m) SQUARE(MOVE_Y(m), MOVE_X(m))		/* DESTINATION OR SLOT */
+
+#define MOVE_NONE ((Move) 0xFFFFFFFF)	/* NO MOVE (NOT A VALID PLAYER) */
+#define MAX_MOVES (4 + 2 * WALL_DIMENSION * WALL_DIMENSION)	/* 4 TOKEN MOVES, 72 WALL SLOTS */
+
+typedef struct {
+	Move move[MAX_MOVES];
+	int count;
+} MoveList;
+
+/**
+ * @brief What make_move changed, so that unmake_move can restore it exactly.
+ *
+ * @details The board needs only the previous square of the token (walls are
+ * removed, the key follows incrementally). Of the cache, the paths always change, while
+ * the distances change at once only for a wall that cuts a path: only those are saved.
+ */
+typedef struct {
+	Move move;
+	int from;													/* PREVIOUS SQUARE OF THE TOKEN */
+	Bits path_s[2], path_e[2];				/* PREVIOUS PATHS OF THE CACHE */
+	int length[2];
+	Bits stale_h[2], stale_v[2];			/* PREVIOUS WALLS NOT YET IN THE DISTANCES (WALLS ONLY) */
+	int saved;												/* BIT p SET IF dist[p] IS SAVED */
+	uint8_t dist[2][BOARD_SQUARES];
+} Undo;
+
+/* SCORES OF THE SEARCH, FROM THE POINT OF VIEW OF THE PLAYER TO MOVE */
+#define SCORE_STEP 10		/* ONE STEP OF DIFFERENCE BETWEEN THE SHORTEST PATHS */
+#define SCORE_WALL 4		/* ONE WALL MORE THAN THE OPPONENT */
+#define SCORE_WIN 10000	/* MATCH WON (MINUS THE PLIES NEEDED) */
+#define SEARCH_MAX_DEPTH 32
+
+/**
+ * @brief Entry of the transposition table: result of the search of a position
+ * (unpacked from its slot by tt_probe).
+ *
+ * @details 'flags' holds the kind of bound (bits 1:0, 0 for an empty entry) and
+ * the generation of the search that stored it (bits 7:2).
+ */
+typedef struct {
+	uint64_t key;			/* ZOBRIST KEY, SIDE TO MOVE INCLUDED */
+	Move move;				/* BEST MOVE (MOVE_NONE IF UNKNOWN) */
+	int16_t score;
+	uint8_t depth;
+	uint8_t flags;
+} TTEntry;
+
+#define TT_EXACT 1				/* THE SCORE IS EXACT */
+#define TT_LOWER 2				/* THE SCORE IS A LOWER BOUND (CUT-OFF) */
+#define TT_UPPER 3				/* THE SCORE IS AN UPPER BOUND (NO MOVE RAISED ALPHA) */
+#define TT_GENERATION 0x3F
+
+/**
+ * @brief Slot of the transposition table: an entry packed in one word, and the
+ * key XOR that word.
+ *
+ * @details A slot written by two threads at the same time, or read while it is
+ * written, no longer gives back its key, so it is simply a miss: the slots can
+ * be shared by the threads of a parallel search without any lock.
+ */
+typedef struct {
+	uint64_t check;		/* KEY ^ data */
+	uint64_t data;		/* MOVE [31:0], SCORE [47:32], DEPTH [55:48], FLAGS [63:56] */
+} TTSlot;
+
+/**
+ * @brief Transposition table, with a power of two of entries. The memory is
+ * supplied at startup (tt_init): a few KB on the board, hundreds of MB on the host.
+ * Threads of a parallel search share the slots, each through its own table
+ * (tt_share): generation, counters and the entry found are of the thread.
+ */
+typedef struct {
+	TTSlot *slot;
+	uint32_t mask;						/* ENTRIES - 1 */
+	int generation;						/* SEARCH COUNTER, FOR THE REPLACEMENT */
+	uint32_t probes, hits, stores;
+	TTEntry found;						/* ENTRY GIVEN BY THE LAST tt_probe */
+} TransTable;
+
+/**
+ * @brief Limits and results of a search (see search_best_move).
+ *
+ * @details 'clock_ms' is a millisecond clock supplied by the platform (a
+ * timer on the board, the monotonic clock on the host). Without a clock or
+ * with 'budget_ms' equal to 0 only the depth limit applies. In a parallel
+ * search (lazy SMP, see host/smp_search.c) all the threads search the same
+ * position on one shared table: the helpers start one depth ahead (odd ones)
+ * and try the root moves in another order, and stop when 'abort' is set.
+ */
+typedef struct {
+	int max_depth;							/* DEPTH OF THE LAST ITERATION, IN PLIES */
+	uint32_t budget_ms;					/* TIME BUDGET (0 FOR NONE) */
+	uint32_t (*clock_ms)(void);	/* MILLISECOND CLOCK (NULL FOR NONE) */
+	TransTable *tt;							/* TRANSPOSITION TABLE (NULL FOR NONE) */
+	Move best;									/* RESULT: BEST MOVE */
+	int score, depth;						/* RESULT: ITS SCORE AND THE LAST DEPTH COMPLETED */
+	uint32_t nodes;							/* RESULT: POSITIONS VISITED */
+	uint32_t start_ms;
+	int stop;										/* 1 WHEN THE TIME BUDGET IS OVER */
+	const volatile int *abort;	/* SET BY ANOTHER THREAD TO STOP THE SEARCH (NULL FOR NONE) */
+	int helper;									/* 0, OR INDEX OF A HELPER OF A PARALLEL SEARCH */
+} Search;
+
+/**
+ * @brief Search in the background during the turn of the opponent (pondering).
+ *
+ * @details ponder_start copies the position, so the slices never read the
+ * match, which may change at any time (the joystick on the board, another
+ * thread on the host). Each slice searches it one depth deeper than the last
+ * one completed, on the table of the computer player: the depths already done
+ * come back from the table at once, and when the opponent has moved the search
+ * of the computer finds there the positions that follow the move.
+ */
+typedef struct {
+	Board board;
+	PathCache paths;
+	int id_player;							/* PLAYER TO MOVE (THE OPPONENT OF THE COMPUTER) */
+	Search search;							/* TABLE AND CLOCK OF THE SLICES */
+	int depth;									/* LAST DEPTH COMPLETED (0 FOR NONE) */
+	uint32_t slices, nodes;
+	volatile int abort;					/* SET WHEN THE OPPONENT MOVES: NO MORE SLICES */
+} Ponder;
+
+/**
+ * @brief Node of the Monte Carlo tree (see mcts.c), in an arena supplied by
+ * the caller. The children of a node are contiguous in the arena.
+ */
+typedef struct {
+	Move move;									/* MOVE THAT LEADS HERE (MOVE_NONE FOR A PASS) */
+	uint32_t child;							/* FIRST CHILD, 0 IF NOT EXPANDED (0 IS THE ROOT) */
+	uint16_t children;
+	uint16_t reserved;
+	uint32_t visits;
+	uint32_t score;							/* RESULTS OF THE PLAYOUTS FOR THE PLAYER OF 'move' (mcts.c) */
+} MctsNode;
+
+/**
+ * @brief Limits and results of a Monte Carlo tree search (see mcts_best_move).
+ *
+ * @details The search stops after 'playouts' playouts or after 'budget_ms'
+ * milliseconds of 'clock_ms' (0 for no limit, one of the two is needed). With
+ * the arena full the tree stops growing and the playouts go on from its leaves.
+ */
+typedef struct {
+	MctsNode *node;							/* ARENA OF THE NODES */
+	uint32_t capacity, used;		/* NODES OF THE ARENA, NODES IN USE */
+	uint32_t playouts;					/* LIMIT OF PLAYOUTS (0 FOR NONE) */
+	uint32_t budget_ms;					/* TIME BUDGET (0 FOR NONE) */
+	uint32_t (*clock_ms)(void);	/* MILLISECOND CLOCK (NULL FOR NONE) */
+	uint32_t seed;							/* STATE OF THE RANDOM GENERATOR OF THE ROLLOUTS */
+	Move best;									/* RESULT: MOST VISITED MOVE OF THE ROOT */
+	uint32_t done;							/* RESULT: PLAYOUTS */
+	uint32_t rollout_plies;			/* RESULT: PLIES PLAYED BY THE ROLLOUTS */
+	int win_rate;								/* RESULT: MEAN RESULT OF THE BEST MOVE, PER CENT */
+} Mcts;
+
+/* GAME RECORDS: A LOG IS A STREAM OF GAMES, ONE BYTE FOR EACH MOVE (THE PLAYER
+	 FOLLOWS FROM THE ORDER OF THE MOVES), CLOSED BY A BYTE WITH THE WINNER:
+		0..48    token moved to the square
+		49..120  wall: 49 + 36*horizontal + 6*row + col of the slot
+		121      pass (the player to move had no legal move)
+		 (on 9x9: squares 0..80, walls 81 + 64*horizontal + 8*row + col, pass 209)
+		0xF0 | w end of the game, w = winner (0 if unfinished) */
+#define LOG_WALL_CODE BOARD_SQUARES
+#define LOG_PASS (LOG_WALL_CODE + 2 * WALL_DIMENSION * WALL_DIMENSION)
+#define LOG_END 0xF0
+
+/**
+ * @brief Append-only log of games, written while they are played.
+ *
+ * @details The bytes go to a buffer supplied by the caller (RAM or flash on
+ * the board, a large block on the host). When it is full they are given to
+ * 'sink' if there is one (a file on the host, in chunks: a game may span two
+ * of them); without a sink the open game is dropped and the games already
+ * closed stay in the buffer.
+ */
+typedef struct {
+	uint8_t *data;
+	uint32_t capacity, length;					/* BYTES */
+	uint32_t game_start;								/* FIRST BYTE OF THE OPEN GAME */
+	void (*sink)(const uint8_t *data, uint32_t length);
+	int side;														/* PLAYER OF THE NEXT MOVE, 0 IF NO GAME IS OPEN */
+	int dropped;												/* THE OPEN GAME DID NOT FIT */
+	uint32_t games, lost;								/* GAMES CLOSED, GAMES DROPPED */
+} GameLog;
+
+/**
+ * @brief Reader of a log, in one block or in chunks (log_reader_feed).
+ */
+typedef struct {
+	const uint8_t *data;
+	uint32_t length, pos;
+	int side;														/* PLAYER OF THE NEXT MOVE */
+	int winner;													/* OF THE LAST GAME READ */
+	uint32_t games, moves;							/* READ SO FAR */
+} LogReader;
+
+#define LOG_READ_MOVE 1
+#define LOG_READ_END 0				/* END OF A GAME, WINNER IN 'winner' */
+#define LOG_READ_MORE (-1)		/* END OF THE DATA (FEED THE NEXT CHUNK) */
+#define LOG_READ_BAD (-2)			/* NOT A CODE OF THE FORMAT */
+
+extern const int step_offset[4];
+extern uint64_t zobrist_pawn[2][BOARD_SQUARES];
+extern uint64_t zobrist_wall[2][2][BOARD_SQUARES];
+extern uint64_t zobrist_walls_left[2][WALLS_PER_PLAYER + 1];
+extern uint64_t zobrist_side;
+
+/**
+ * @brief Index of the least significant bit set (the mask must not be 0).
+ */
+static __inline int bit_scan64(uint64_t m) {
+#if defined(__GNUC__)
+	return __builtin_ctzll(m);
+#else
+	static const uint8_t debruijn[64] = {
+		 0,  1, 48,  2, 57, 49, 28,  3, 61, 58, 50, 42, 38, 29, 17,  4,
+		62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12,  5,
+		63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+		46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19,  9, 13,  8,  7,  6};
+	return debruijn[((m & (0 - m)) * 0x03F79D71B4CB0A89ULL) >> 58];
+#endif
+}
+
+static __inline int bit_scan(Bits m) {
+#if BOARD_SQUARES < 64
+	return bit_scan64(m);
+#else
+	uint64_t low = (uint64_t) m;
+	return low ? bit_scan64(low) : 64 + bit_scan64((uint64_t) (m >> 64));
+#endif
+}
+
+/**
+ * @brief Key of a position with the side to move (the key of the board does not include it).
+ */
+static __inline uint64_t board_key(const Board *b, int id_player) {
+	return id_player == 2 ? b->key ^ zobrist_side : b->key;
+}
+
+/**
+ * @brief Mask of the squares from which a step in the given direction is not
+ * possible (edge of the board or wall).
+ */
+static __inline Bits board_closed(const Board *b, int dir) {
+	switch(dir) {
+		case DIR_DOWN:	return b->block_s | ROW_LAST;
+		case DIR_LEFT:	return (b->block_e << 1) | COL_FIRST;
+		case DIR_RIGHT:	return b->block_e | COL_LAST;
+		default:				return (b->block_s << BOARD_DIMENSION) | ROW_FIRST;
+	}
+}
+
+/**
+ * @brief Mask of the slots that conflict with a wall in the given slot: the
+ * same slot and the two adjacent ones with the same orientation (overlap) and
+ * the slot with the other orientation that shares the center (crossing).
+ */
+static __inline Bits board_wall_conflicts(const Board *b, int horizontal, int slot) {
+	Bits s = BIT(slot);
+	if(horizontal)
+		return (b->wall_h & (s | s << 1 | s >> 1) & SLOTS_MASK) | (b->wall_v & s);
+	return (b->wall_v & (s | s << BOARD_DIMENSION | s >> BOARD_DIMENSION) & SLOTS_MASK) | (b->wall_h & s);
+}
+
+/**
+ * @brief Mask of the slots where a wall with the given orientation does not
+ * conflict (overlap or crossing) with the walls already on the board. Kept
+ * up to date by board_place_wall and board_remove_wall: a read, no arithmetic.
+ */
+static __inline Bits board_free_slots(const Board *b, int horizontal) {
+	return horizontal ? b->free_h : b->free_v;
+}
+
+/**
+ * @brief Number of bits set in a mask.
+ */
+static __inline int bit_count(Bits m) {
+#if defined(__GNUC__) && BOARD_SQUARES < 64
+	return __builtin_popcountll(m);
+#elif defined(__GNUC__)
+	return __builtin_popcountll((uint64_t) m) + __builtin_popcountll((uint64_t) (m >> 64));
+#else
+	int count = 0;
+	for(; m; m &= m - 1)
+		count++;
+	return count;
+#endif
+}
+
+/* board.c */
+void board_init(Board *b);
+void board_set_pawn(Board *b, int id_player, int sq);
+void board_start(Board *b);
+int board_winner(const Board *b);
+void board_place_wall(Board *b, int horizontal, int slot, int id_player);
+void board_remove_wall(Board *b, int horizontal, int slot);
+int board_step(const Board *b, int sq, int dir);
+int board_cell(const Board *b, int i, int j);
+
+/* path.c */
+Bits board_reach(const Board *b, Bits from);
+int board_trapped(const Board *b, int horizontal, int slot);
+void path_cache_init(PathCache *pc, const Board *b);
+int path_cache_cut(const PathCache *pc, int horizontal, int slot);
+int path_cache_traps(PathCache *pc, const Board *b, int horizontal, int slot);
+void path_cache_place_wall(PathCache *pc, const Board *b, int horizontal, int slot);
+void path_cache_move_pawn(PathCache *pc, const Board *b, int id_player, int from);
+const uint8_t *path_cache_dist(PathCache *pc, const Board *b, int id_player);
+void path_cache_refresh(PathCache *pc, const Board *b, int id_player);
+int path_cache_hit_rate(const PathCache *pc);
+
+/* hash.c */
+void zobrist_init(void);		/* ONCE AT STARTUP, BEFORE ANY board_init AND ANY THREAD */
+uint64_t board_compute_key(const Board *b);
+void tt_init(TransTable *tt, TTSlot *buffer, uint32_t entries);
+void tt_share(TransTable *tt, const TransTable *from);
+void tt_clear(TransTable *tt);
+void tt_new_search(TransTable *tt);
+const TTEntry *tt_probe(TransTable *tt, uint64_t key);
+void tt_store(TransTable *tt, uint64_t key, int depth, int bound, int score, Move move);
+
+/* movegen.c */
+int board_gen_pawn_moves(const Board *b, int id_player, MoveList *list);
+int board_gen_moves(const Board *b, PathCache *pc, int id_player, MoveList *list);
+int board_gen_candidates(const Board *b, int id_player, MoveList *list);
+void board_play(Board *b, PathCache *pc, Move m);
+void make_move(Board *b, PathCache *pc, Move m, Undo *u);
+void unmake_move(Board *b, PathCache *pc, const Undo *u);
+uint64_t board_perft(Board *b, PathCache *pc, int id_player, int depth);
+
+/* search.c */
+int search_evaluate(const Board *b, const PathCache *pc, int id_player);
+void search_init(Search *s);
+Move search_best_move(Search *s, const Board *b, const PathCache *pc, int id_player);
+void ponder_start(Ponder *p, const Board *b, const PathCache *pc, int id_player, TransTable *tt, uint32_t (*clock_ms)(void));
+int ponder_slice(Ponder *p, uint32_t budget_ms);
+
+/* mcts.c */
+void mcts_init(Mcts *m, MctsNode *arena, uint32_t capacity);
+int mcts_rollout(Board *b, PathCache *pc, int id_player, uint32_t *seed, uint32_t *plies);
+Move mcts_best_move(Mcts *m, const Board *b, const PathCache *pc, int id_player);
+
+/* record.c */
+int log_encode(Move m);
+Move log_decode(int code, int id_player);
+void log_init(GameLog *log, uint8_t *buffer, uint32_t capacity, void (*sink)(const uint8_t *data, uint32_t length));
+void log_begin_game(GameLog *log);
+void log_move(GameLog *log, Move m);
+void log_end_game(GameLog *log, int winner);
+void log_flush(GameLog *log);
+void log_reader_init(LogReader *r, const uint8_t *data, uint32_t length);
+void log_reader_feed(LogReader *r, const uint8_t *data, uint32_t length);
+int log_read(LogReader *r, Move *m);
+
+#endif
@@ -0,0 +1,223 @@
+#include "Engine.h"
+
+const int step_offset[4] = {BOARD_DIMENSION, -1, 1, -BOARD_DIMENSION};	/* DOWN, LEFT, RIGHT, UP */
+
+/**
+ * @brief Initialization of the bitboard. No walls and no tokens on the board,
+ * 8 walls available for each player. The first call also fills the tables of
+ * the Zobrist keys.
+ *
+ * @param b  The board to be initialized.
+ *
+ * @return Nothing
+ */
+void board_init(Board *b) {
+	b->pawn[0] = NO_SQUARE;
+	b->pawn[1] = NO_SQUARE;
+	b->walls[0] = b->walls[1] = WALLS_PER_PLAYER;
+	b->wall_h = b->wall_v = 0;
+	b->owner_h = b->owner_v = 0;
+	b->block_s = b->block_e = 0;
+	b->free_h = b->free_v = SLOTS_MASK;
+	b->key = zobrist_walls_left[0][WALLS_PER_PLAYER] ^ zobrist_walls_left[1][WALLS_PER_PLAYER];
+}
+
+/**
+ * @brief Put the token of a player on a square (0 to 48).
+ *
+ * @param b  The board.
+ * @param id_player  The id of the player (1 or 2).
+ * @param sq  The new square of the token.
+ *
+ * @return Nothing
+ */
+void board_set_pawn(Board *b, int id_player, int sq) {
+	int p = id_player - 1;
+	if(b->pawn[p] != NO_SQUARE)
+		b->key ^= zobrist_pawn[p][b->pawn[p]];
+	b->pawn[p] = sq;
+	if(sq != NO_SQUARE)
+		b->key ^= zobrist_pawn[p][sq];
+}
+
+/**
+ * @brief Put the tokens in their starting squares: player1 in the middle of
+ * row 0, player2 in the middle of row 6.
+ *
+ * @param b  The board.
+ *
+ * @return Nothing
+ */
+void board_start(Board *b) {
+	board_set_pawn(b, 1, SQUARE(0, BOARD_DIMENSION / 2));
+	board_set_pawn(b, 2, SQUARE(BOARD_DIMENSION - 1, BOARD_DIMENSION / 2));
+}
+
+/**
+ * @brief Winner of the match, if any: player1 wins on row 6, player2 on row 0.
+ *
+ * @param b  The board.
+ *
+ * @return 1 or 2, 0 if the match is not over (or a token is not on the board).
+ */
+int board_winner(const Board *b) {
+	if(b->pawn[0] != NO_SQUARE && ROW_OF(b->pawn[0]) == BOARD_DIMENSION - 1)
+		return 1;
+	if(b->pawn[1] != NO_SQUARE && ROW_OF(b->pawn[1]) == 0)		/* ROW_OF(NO_SQUARE) IS 0 */
+		return 2;
+	return 0;
+}
+
+/**
+ * @brief Insert a wall in a slot and close the two steps it crosses.
+ *
+ * @details An horizontal wall in slot (row, col) closes the steps down from
+ * (row, col) and (row, col+1). A vertical one closes the steps right from
+ * (row, col) and (row+1, col). The slot, the two next to it with the same
+ * orientation (overlap) and the same slot with the other one (crossing) are no
+ * longer free. The player has one wall less available. No check is made on overlaps.
+ *
+ * @param b  The board.
+ * @param horizontal  1 for an horizontal wall, 0 for a vertical one.
+ * @param slot  The slot of the wall.
+ * @param id_player  The id of the player that owns the wall (1 or 2).
+ *
+ * @return Nothing
+ */
+void board_place_wall(Board *b, int horizontal, int slot, int id_player) {
+	Bits s = BIT(slot);
+	int p = id_player - 1;
+	b->key ^= zobrist_walls_left[p][b->walls[p]] ^ zobrist_walls_left[p][b->walls[p] - 1] ^ zobrist_wall[p][horizontal][slot];
+	b->walls[p]--;
+	if(horizontal) {
+		b->wall_h |= s;
+		if(id_player == 2)
+			b->owner_h |= s;
+		b->block_s |= s | s << 1;
+		b->free_h &= ~(s | s << 1 | s >> 1);
+		b->free_v &= ~s;
+	} else {
+		b->wall_v |= s;
+		if(id_player == 2)
+			b->owner_v |= s;
+		b->block_e |= s | s << BOARD_DIMENSION;
+		b->free_v &= ~(s | s << BOARD_DIMENSION | s >> BOARD_DIMENSION);
+		b->free_h &= ~s;
+	}
+}
+
+/**
+ * @brief Value of a wall slot in the legacy encoding (3 for player1, 4 for player2).
+ */
+static int wall_value(const Board *b, int horizontal, int slot) {
+	if(horizontal)
+		return b->owner_h >> slot & 1 ? 4 : 3;
+	return b->owner_v >> slot & 1 ? 4 : 3;
+}
+
+/**
+ * @brief Remove a wall from a slot.
+ *
+ * @details The closed steps and the free slots are rebuilt from the remaining
+ * walls, so that removing a wall never opens a step still closed (or a slot
+ * still taken) by another one. The wall
+ * is given back to its owner.
+ *
+ * @param b  The board.
+ * @param horizontal  1 for an horizontal wall, 0 for a vertical one.
+ * @param slot  The slot of the wall.
+ *
+ * @return Nothing
+ */
+void board_remove_wall(Board *b, int horizontal, int slot) {
+	int p = wall_value(b, horizontal, slot) - 3;
+	b->key ^= zobrist_walls_left[p][b->walls[p]] ^ zobrist_walls_left[p][b->walls[p] + 1] ^ zobrist_wall[p][horizontal][slot];
+	b->walls[p]++;
+	if(horizontal) {
+		b->wall_h &= ~BIT(slot);
+		b->owner_h &= ~BIT(slot);
+		b->block_s = b->wall_h | b->wall_h << 1;
+	} else {
+		b->wall_v &= ~BIT(slot);
+		b->owner_v &= ~BIT(slot);
+		b->block_e = b->wall_v | b->wall_v << BOARD_DIMENSION;
+	}
+	b->free_h = SLOTS_MASK & ~(b->wall_h | b->wall_h << 1 | b->wall_h >> 1 | b->wall_v);
+	b->free_v = SLOTS_MASK & ~(b->wall_v | b->wall_v << BOARD_DIMENSION | b->wall_v >> BOARD_DIMENSION | b->wall_h);
+}
+
+/**
+ * @brief Destination of a token that moves in a direction.
+ *
+ * @details If the adjacent square is occupied by the opponent, the token
+ * jumps over it (face to face), provided that no wall is behind the opponent.
+ *
+ * @param b  The board.
+ * @param sq  The current square of the token.
+ * @param dir  The direction (DIR_DOWN, DIR_LEFT, DIR_RIGHT, DIR_UP).
+ *
+ * @return The destination square, NO_SQUARE if the move is not possible.
+ */
+int board_step(const Board *b, int sq, int dir) {
+	Bits closed = board_closed(b, dir);
+	int next;
+
+	if(closed >> sq & 1)
+		return NO_SQUARE;
+	next = sq + step_offset[dir];
+	if(next != b->pawn[0] && next != b->pawn[1])
+		return next;
+	/* FACE TO FACE. NO JUMP IF OUT OF THE BOARD OR WALL BEHIND THE OPPONENT */
+	if(closed >> next & 1)
+		return NO_SQUARE;
+	return next + step_offset[dir];
+}
+
+/**
+ * @brief Legacy 13x13 view of the board, derived from the bitboard.
+ *
+ * @details Tokens occupy cells with even row and even column indexes, walls
+ * occupy the remaining ones. Each wall covers 3 cells (2 squares and the space
+ * between them). The value of a cell is 0 if free, 1 or 2 if player1 or player2
+ * is present, 3 or 4 if a wall of player1 or player2 is present.
+ *
+ * @param b  The board.
+ * @param i  The row index in the 13x13 matrix.
+ * @param j  The column index in the 13x13 matrix.
+ *
+ * @return The value of the cell.
+ */
+int board_cell(const Board *b, int i, int j) {
+	int row = i / 2, col = j / 2, sq = SQUARE(i / 2, j / 2);
+
+	if(i < 0 || j < 0 || i >= BOARD_DIM || j >= BOARD_DIM)
+		return 0;
+	/* #1 SQUARE (EVEN ROW, EVEN COLUMN) */
+	if(i % 2 == 0 && j % 2 == 0) {
+		if(sq == b->pawn[0])
+			return 1;
+		return sq == b->pawn[1] ? 2 : 0;
+	}
+	/* #2 SPACE BELOW A SQUARE: HORIZONTAL WALL IN SLOT (row, col) OR (row, col-1) */
+	if(j % 2 == 0) {
+		if(col < WALL_DIMENSION && (b->wall_h >> sq & 1))
+			return wall_value(b, 1, sq);
+		if(col > 0 && (b->wall_h >> (sq - 1) & 1))
+			return wall_value(b, 1, sq - 1);
+		return 0;
+	}
+	/* #3 SPACE ON THE RIGHT OF A SQUARE: VERTICAL WALL IN SLOT (row, col) OR (row-1, col) */
+	if(i % 2 == 0) {
+		if(row < WALL_DIMENSION && (b->wall_v >> sq & 1))
+			return wall_value(b, 0, sq);
+		if(row > 0 && (b->wall_v >> (sq - BOARD_DIMENSION) & 1))
+			return wall_value(b, 0, sq - BOARD_DIMENSION);
+		return 0;
+	}
+	/* #4 CENTER OF A SLOT: HORIZONTAL OR VERTICAL WALL */
+	if(b->wall_h >> sq & 1)
+		return wall_value(b, 1, sq);
+	if(b->wall_v >> sq & 1)
+		return wall_value(b, 0, sq);
+	return 0;
+}
@@ -0,0 +1,209 @@
+#include <stddef.h>
+#include "Engine.h"
+
+/* ***************   ZOBRIST KEYS   *************** */
+/* One random 64-bit number for every token square, every wall slot (per
+	 orientation and per owner, as the values 3 and 4 of the 13x13 view), every
+	 number of walls left and the side to move. The key of a position is the XOR
+	 of the numbers of its features, kept up to date by the functions of board.c. */
+
+uint64_t zobrist_pawn[2][BOARD_SQUARES];
+uint64_t zobrist_wall[2][2][BOARD_SQUARES];		/* [OWNER][HORIZONTAL][SLOT] */
+uint64_t zobrist_walls_left[2][WALLS_PER_PLAYER + 1];
+uint64_t zobrist_side;		/* PLAYER2 TO MOVE */
+
+/**
+ * @brief Pseudo-random number (xorshift64*), fixed seed: keys are the same at every run.
+ */
+static uint64_t zobrist_random(uint64_t *state) {
+	*state ^= *state >> 12;
+	*state ^= *state << 25;
+	*state ^= *state >> 27;
+	return *state * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+ * @brief Fill the tables of the Zobrist keys. Called once at startup, before
+ * the first board_init and before any other thread runs (see Engine.h): the
+ * tables are then only read, by any number of threads.
+ *
+ * @return Nothing
+ */
+void zobrist_init(void) {
+	uint64_t state = 0x9E3779B97F4A7C15ULL;
+	int p, h, i;
+
+	for(p = 0; p < 2; p++) {
+		for(i = 0; i < BOARD_SQUARES; i++)
+			zobrist_pawn[p][i] = zobrist_random(&state);
+		for(h = 0; h < 2; h++)
+			for(i = 0; i < BOARD_SQUARES; i++)
+				zobrist_wall[p][h][i] = zobrist_random(&state);
+		for(i = 0; i <= WALLS_PER_PLAYER; i++)
+			zobrist_walls_left[p][i] = zobrist_random(&state);
+	}
+	zobrist_side = zobrist_random(&state);
+}
+
+/**
+ * @brief Key of a board computed from scratch (the incremental one is 'b->key').
+ *
+ * @param b  The board.
+ *
+ * @return The key (side to move not included).
+ */
+uint64_t board_compute_key(const Board *b) {
+	uint64_t key = 0;
+	Bits m;
+	int p;
+
+	for(p = 0; p < 2; p++) {
+		if(b->pawn[p] != NO_SQUARE)
+			key ^= zobrist_pawn[p][b->pawn[p]];
+		key ^= zobrist_walls_left[p][b->walls[p]];
+	}
+	for(m = b->wall_h; m; m &= m - 1)
+		key ^= zobrist_wall[(int) (b->owner_h >> bit_scan(m) & 1)][1][bit_scan(m)];
+	for(m = b->wall_v; m; m &= m - 1)
+		key ^= zobrist_wall[(int) (b->owner_v >> bit_scan(m) & 1)][0][bit_scan(m)];
+	return key;
+}
+
+/* ***************   TRANSPOSITION TABLE   *************** */
+
+/* Words of the slots. On a 64-bit host they are read and written in one access
+	 (relaxed atomics): the threads of a parallel search may use them at the same
+	 time. Elsewhere, with a single thread, plain accesses. */
+#if defined(__GNUC__) && defined(__SIZEOF_POINTER__) && __SIZEOF_POINTER__ == 8
+#define SLOT_LOAD(w) __atomic_load_n(&(w), __ATOMIC_RELAXED)
+#define SLOT_WRITE(w, v) __atomic_store_n(&(w), (v), __ATOMIC_RELAXED)
+#else
+#define SLOT_LOAD(w) (w)
+#define SLOT_WRITE(w, v) ((w) = (v))
+#endif
+
+#define DATA_FLAGS(data) ((int) ((data) >> 56))
+#define DATA_DEPTH(data) ((int) ((data) >> 48 & 0xFF))
+
+/**
+ * @brief Prepare a transposition table on a buffer supplied by the caller (a
+ * static array on the board, a large allocation on the host).
+ *
+ * @details Only a power of two of entries is used (the largest that fits).
+ *
+ * @param tt  The table.
+ * @param buffer  The memory of the entries.
+ * @param entries  The number of entries of the buffer (at least 1).
+ *
+ * @return Nothing
+ */
+void tt_init(TransTable *tt, TTSlot *buffer, uint32_t entries) {
+	uint32_t size = 1;
+	while(size <= entries / 2)
+		size *= 2;
+	tt->slot = buffer;
+	tt->mask = size - 1;
+	tt_clear(tt);
+}
+
+/**
+ * @brief Table of another thread on the entries of a table (parallel search).
+ *
+ * @details The generation is copied: call it again, for every thread, when
+ * the owner of the entries has started a new search or cleared them.
+ *
+ * @param tt  The table of the thread.
+ * @param from  The table that owns the entries.
+ *
+ * @return Nothing
+ */
+void tt_share(TransTable *tt, const TransTable *from) {
+	tt->slot = from->slot;
+	tt->mask = from->mask;
+	tt->generation = from->generation;
+	tt->probes = tt->hits = tt->stores = 0;
+}
+
+/**
+ * @brief Empty a transposition table and reset its counters.
+ *
+ * @param tt  The table.
+ *
+ * @return Nothing
+ */
+void tt_clear(TransTable *tt) {
+	uint32_t i;
+	for(i = 0; i <= tt->mask; i++)
+		tt->slot[i].check = tt->slot[i].data = 0;
+	tt->generation = 0;
+	tt->probes = tt->hits = tt->stores = 0;
+}
+
+/**
+ * @brief Start a new search: entries of the previous searches can be replaced
+ * even if deeper.
+ *
+ * @param tt  The table.
+ *
+ * @return Nothing
+ */
+void tt_new_search(TransTable *tt) {
+	tt->generation = (tt->generation + 1) & TT_GENERATION;
+}
+
+/**
+ * @brief Look for a position in the table.
+ *
+ * @param tt  The table.
+ * @param key  The key of the position (side to move included).
+ *
+ * @return A copy of the entry of the position (valid until the next probe),
+ * NULL if not present.
+ */
+const TTEntry *tt_probe(TransTable *tt, uint64_t key) {
+	TTSlot *e = &tt->slot[key & tt->mask];
+	uint64_t data = SLOT_LOAD(e->data);
+
+	tt->probes++;
+	if((SLOT_LOAD(e->check) ^ data) != key || !DATA_FLAGS(data))
+		return NULL;
+	tt->hits++;
+	tt->found.key = key;
+	tt->found.move = (Move) data;
+	tt->found.score = (int16_t) (data >> 32);
+	tt->found.depth = (uint8_t) DATA_DEPTH(data);
+	tt->found.flags = (uint8_t) DATA_FLAGS(data);
+	return &tt->found;
+}
+
+/**
+ * @brief Store the result of a search in the table (replace by depth).
+ *
+ * @details The entry of the slot is replaced if it holds another position from
+ * a previous search, or if the new result is at least as deep. The best move
+ * of the old entry is kept when the new result has none.
+ *
+ * @param tt  The table.
+ * @param key  The key of the position (side to move included).
+ * @param depth  The depth of the search.
+ * @param bound  TT_EXACT, TT_LOWER or TT_UPPER.
+ * @param score  The score (wins relative to the position, see search.c).
+ * @param move  The best move, MOVE_NONE if unknown.
+ *
+ * @return Nothing
+ */
+void tt_store(TransTable *tt, uint64_t key, int depth, int bound, int score, Move move) {
+	TTSlot *e = &tt->slot[key & tt->mask];
+	uint64_t old = SLOT_LOAD(e->data), data;
+	int flags = DATA_FLAGS(old);
+
+	if(flags && (flags & TT_GENERATION << 2) == tt->generation << 2 && depth < DATA_DEPTH(old))
+		return;
+	if(move == MOVE_NONE && (SLOT_LOAD(e->check) ^ old) == key)
+		move = (Move) old;
+	data = (uint64_t) move | (uint64_t) (uint16_t) score << 32 | (uint64_t) (uint8_t) depth << 48
+		| (uint64_t) (bound | tt->generation << 2) << 56;
+	SLOT_WRITE(e->check, key ^ data);
+	SLOT_WRITE(e->data, data);
+	tt->stores++;
+}
@@ -0,0 +1,346 @@
+#include "Engine.h"
+
+/* ***************   MONTE CARLO TREE SEARCH (COMPUTER PLAYER)   *************** */
+/* UCT: every playout goes down the tree choosing the child with the best upper
+	 confidence bound, adds the children of the leaf it reaches (if already
+	 visited), plays a fast biased rollout to the end of the match and gives the
+	 result to all the nodes on its way. The nodes live in an arena supplied by
+	 the caller (no allocation at all), the children of a node side by side.
+	 Values are in 16.16 fixed point: the board has no floating point unit.
+
+	 To keep the tree narrow, a node gets as children the token moves and only
+	 the walls that cut the shortest path of the opponent. The rollouts play
+	 mostly steps along the shortest path of the player, sometimes a random
+	 step or a wall across the path of the opponent; when no walls are left the
+	 match is a race and its winner is known at once. A win is worth a bit less
+	 the longer the playout (a loss a bit more): without it, a won position
+	 would have all its moves at 100% and the token would wander. */
+
+#define MCTS_MAX_DEPTH 64				/* NODES ON THE WAY OF A PLAYOUT */
+#define MCTS_DEFAULT_PLAYOUTS 1000	/* WITH NEITHER A LIMIT OF PLAYOUTS NOR OF TIME */
+#define CHECK_CLOCK 15					/* THE CLOCK IS READ EVERY 16 PLAYOUTS */
+#define ROLLOUT_PLIES 100				/* THEN THE SHORTER PATH WINS */
+#define WALL_ONE_IN 5						/* WALL IN A ROLLOUT, WHEN THE OPPONENT IS NOT BEHIND */
+#define RANDOM_STEP_ONE_IN 8		/* RANDOM TOKEN MOVE IN A ROLLOUT */
+#define WIN_POINTS 256					/* RESULT OF A PLAYOUT: WIN IN NO PLIES (LOSS 0, DRAW HALF) */
+#define LENGTH_POINTS 64				/* AT MOST, TAKEN FROM A WIN (AND GIVEN TO A LOSS), 1 PER PLY */
+#define FIXED_ONE 65536
+#define LN2_FIXED 45426					/* ln(2) IN 16.16 */
+
+static uint32_t next_random(uint32_t *seed) {
+	*seed ^= *seed << 13;
+	*seed ^= *seed >> 17;
+	*seed ^= *seed << 5;
+	return *seed;
+}
+
+/**
+ * @brief Integer square root (floor).
+ */
+static uint32_t isqrt64(uint64_t x) {
+	uint64_t root = 0, bit = (uint64_t) 1 << 62;
+
+	while(bit > x)
+		bit >>= 2;
+	while(bit) {
+		if(x >= root + bit) {
+			x -= root + bit;
+			root = (root >> 1) + bit;
+		} else
+			root >>= 1;
+		bit >>= 2;
+	}
+	return (uint32_t) root;
+}
+
+/**
+ * @brief Natural logarithm of a positive integer, in 16.16 (log2 with a linear
+ * fraction, error below 0.06).
+ */
+static uint32_t ln_fixed(uint32_t n) {
+	uint32_t k = 0, frac;
+
+	while(n >> (k + 1))
+		k++;
+	frac = k > 16 ? (n >> (k - 16)) - FIXED_ONE : (n << (16 - k)) - FIXED_ONE;
+	return (uint32_t) ((uint64_t) (k << 16 | frac) * LN2_FIXED >> 16);
+}
+
+/* ***************   ROLLOUTS   *************** */
+
+/**
+ * @brief Index of a random bit set of a mask (not 0).
+ */
+static int random_bit(Bits mask, uint32_t *seed) {
+	int k;
+
+	for(k = next_random(seed) % bit_count(mask); k; k--)
+		mask &= mask - 1;
+	return bit_scan(mask);
+}
+
+/**
+ * @brief A wall across a random step of the shortest path of the opponent,
+ * MOVE_NONE if the one drawn is not legal.
+ */
+static Move blocking_wall(const Board *b, PathCache *pc, int id_player, uint32_t *seed) {
+	int opp = 2 - id_player, step, horizontal, slot;
+	Bits steps_s = pc->path_s[opp], steps_e = pc->path_e[opp];
+	uint32_t r = next_random(seed);
+
+	if(!steps_s && !steps_e)
+		return MOVE_NONE;
+	/* A STEP DOWN (OR UP) IS CLOSED BY AN HORIZONTAL WALL IN ITS SLOT OR IN THE ONE ON THE LEFT */
+	horizontal = steps_s && (!steps_e || (r & 1));
+	step = random_bit(horizontal ? steps_s : steps_e, seed);
+	if(horizontal)
+		slot = r & 2 && COL_OF(step) > 0 ? step - 1 : step;
+	else
+		slot = r & 2 && ROW_OF(step) > 0 ? step - BOARD_DIMENSION : step;
+	if(!(board_free_slots(b, horizontal) >> slot & 1) || path_cache_traps(pc, b, horizontal, slot))
+		return MOVE_NONE;
+	return MOVE_WALL(id_player, horizontal, slot);
+}
+
+/**
+ * @brief Move of a rollout: mostly a step along the shortest path, sometimes
+ * a random step or a wall against the opponent.
+ */
+static Move rollout_move(const Board *b, PathCache *pc, int id_player, uint32_t *seed) {
+	MoveList list;
+	int p = id_player - 1, sq = b->pawn[p], dir = -1, dest = NO_SQUARE;
+	uint32_t r = next_random(seed);
+	Move m;
+
+	/* #1 A WALL, IF THE OPPONENT IS NOT BEHIND */
+	if(b->walls[p] && pc->length[1 - p] <= pc->length[p] && r % WALL_ONE_IN == 0) {
+		m = blocking_wall(b, pc, id_player, seed);
+		if(m != MOVE_NONE)
+			return m;
+	}
+	/* #2 THE STEP OF THE SHORTEST PATH THAT LEAVES THE SQUARE OF THE TOKEN */
+	if((r >> 8) % RANDOM_STEP_ONE_IN) {
+		if(pc->path_s[p] >> sq & 1)
+			dir = DIR_DOWN;
+		else if(sq >= BOARD_DIMENSION && pc->path_s[p] >> (sq - BOARD_DIMENSION) & 1)
+			dir = DIR_UP;
+		else if(pc->path_e[p] >> sq & 1)
+			dir = DIR_RIGHT;
+		else if(COL_OF(sq) > 0 && pc->path_e[p] >> (sq - 1) & 1)
+			dir = DIR_LEFT;
+		if(dir >= 0)
+			dest = board_step(b, sq, dir);
+		if(dest != NO_SQUARE)
+			return MOVE_PAWN(id_player, dest);
+	}
+	/* #3 A RANDOM STEP (OR THE PATH IS CLOSED BY THE OPPONENT) */
+	if(!board_gen_pawn_moves(b, id_player, &list))
+		return MOVE_NONE;
+	return list.move[next_random(seed) % list.count];
+}
+
+/**
+ * @brief Fast biased playout of a match to its end.
+ *
+ * @details Once both players have no walls the match is a race: the player
+ * to move wins if its path is not longer. After ROLLOUT_PLIES plies the
+ * shorter path wins (a draw if equal).
+ *
+ * @param b  The board (played on).
+ * @param pc  The cache of the shortest paths, up to date with the board (played on).
+ * @param id_player  The player to move (1 or 2).
+ * @param seed  The state of the random generator (not 0).
+ * @param plies  Counter of the plies played.
+ *
+ * @return The winner (1 or 2), 0 for a draw.
+ */
+int mcts_rollout(Board *b, PathCache *pc, int id_player, uint32_t *seed, uint32_t *plies) {
+	int ply, winner, me, opp;
+	Move m;
+
+	for(ply = 0; ; ply++) {
+		winner = board_winner(b);
+		if(winner)
+			return winner;
+		me = id_player - 1;
+		opp = 1 - me;
+		if(!b->walls[0] && !b->walls[1])
+			return pc->length[me] <= pc->length[opp] ? id_player : 3 - id_player;
+		if(ply == ROLLOUT_PLIES)
+			return pc->length[me] == pc->length[opp] ? 0 : pc->length[me] < pc->length[opp] ? id_player : 3 - id_player;
+		m = rollout_move(b, pc, id_player, seed);
+		if(m != MOVE_NONE)
+			board_play(b, pc, m);
+		id_player = 3 - id_player;
+		(*plies)++;
+	}
+}
+
+/* ***************   TREE   *************** */
+
+/**
+ * @brief Prepare a search on an arena of nodes supplied by the caller: limit of
+ * 1000 playouts, no time budget. The caller may then change playouts,
+ * budget_ms, clock_ms and seed.
+ *
+ * @param m  The search.
+ * @param arena  The nodes (a few thousands on the board, millions on the host).
+ * @param capacity  The number of nodes of the arena (at least 1).
+ *
+ * @return Nothing
+ */
+void mcts_init(Mcts *m, MctsNode *arena, uint32_t capacity) {
+	m->node = arena;
+	m->capacity = capacity;
+	m->used = 0;
+	m->playouts = MCTS_DEFAULT_PLAYOUTS;
+	m->budget_ms = 0;
+	m->clock_ms = 0;
+	m->seed = 2463534242u;
+	m->best = MOVE_NONE;
+	m->done = m->rollout_plies = 0;
+	m->win_rate = 0;
+}
+
+/**
+ * @brief Children of a leaf: its token moves and the walls that cut the
+ * shortest path of the opponent (a pass if there are none).
+ *
+ * @return The number of children, 0 if the arena is full.
+ */
+static int expand(Mcts *m, uint32_t n, const Board *b, PathCache *pc, int id_player) {
+	MoveList list;
+	MctsNode *c;
+	int i, k = 0;
+
+	board_gen_moves(b, pc, id_player, &list);
+	for(i = 0; i < list.count; i++)
+		if(!MOVE_IS_WALL(list.move[i])
+				|| path_cache_cut(pc, MOVE_HORIZONTAL(list.move[i]), MOVE_SQUARE(list.move[i])) >> (2 - id_player) & 1)
+			list.move[k++] = list.move[i];
+	if(!k)
+		list.move[k++] = MOVE_NONE;
+	if(m->capacity - m->used < (uint32_t) k)
+		return 0;
+	m->node[n].child = m->used;
+	m->node[n].children = (uint16_t) k;
+	for(i = 0; i < k; i++) {
+		c = &m->node[m->used++];
+		c->move = list.move[i];
+		c->child = 0;
+		c->children = 0;
+		c->visits = c->score = 0;
+	}
+	return k;
+}
+
+/**
+ * @brief Child with the best upper confidence bound (a child never visited first).
+ */
+static uint32_t select_child(const Mcts *m, uint32_t n) {
+	const MctsNode *c = &m->node[m->node[n].child];
+	uint64_t ln = (uint64_t) ln_fixed(m->node[n].visits) << 16;		/* 32.32: ITS SQUARE ROOT IS IN 16.16 */
+	uint32_t value, best_value = 0, best = 0, i;
+
+	for(i = 0; i < m->node[n].children; i++, c++) {
+		if(!c->visits)
+			return m->node[n].child + i;
+		/* MEAN RESULT (score / WIN_POINTS visits) + sqrt(ln N / visits), IN 16.16 */
+		value = (uint32_t) ((uint64_t) c->score * (FIXED_ONE / WIN_POINTS) / c->visits) + isqrt64(ln / c->visits);
+		if(value > best_value) {
+			best_value = value;
+			best = i;
+		}
+	}
+	return m->node[n].child + best;
+}
+
+/**
+ * @brief Best move of a player, by Monte Carlo tree search.
+ *
+ * @details The tree is built from scratch in the arena at every call. The
+ * result is the most visited move of the root.
+ *
+ * @param m  The search, with its limits. On return 'best', 'done' (playouts),
+ * 'rollout_plies', 'used' (nodes) and 'win_rate' hold the results.
+ * @param b  The board (not modified).
+ * @param pc  The cache of the shortest paths, up to date with the board (not modified).
+ * @param id_player  The player to move (1 or 2).
+ *
+ * @return The best move, MOVE_NONE if the player has no legal move or the match is over.
+ */
+Move mcts_best_move(Mcts *m, const Board *b, const PathCache *pc, int id_player) {
+	Board board = *b;
+	PathCache paths = *pc;
+	uint32_t way[MCTS_MAX_DEPTH], n, limit = m->playouts, start_ms, i, length, win, loss;
+	int len, player, winner, mover;
+	MctsNode *root = m->node;
+
+	m->best = MOVE_NONE;
+	m->done = m->rollout_plies = 0;
+	m->win_rate = 0;
+	if(!limit && !(m->budget_ms && m->clock_ms))
+		limit = MCTS_DEFAULT_PLAYOUTS;
+	start_ms = m->clock_ms ? m->clock_ms() : 0;
+	/* #1 ROOT AND ITS CHILDREN */
+	m->used = 1;
+	root->move = MOVE_NONE;
+	root->child = 0;
+	root->children = 0;
+	root->visits = root->score = 0;
+	if(board_winner(b) || !expand(m, 0, &board, &paths, id_player) || m->node[root->child].move == MOVE_NONE)
+		return MOVE_NONE;
+	while(!limit || m->done < limit) {
+		if(m->budget_ms && m->clock_ms && (m->done & CHECK_CLOCK) == 0 && m->done
+				&& m->clock_ms() - start_ms >= m->budget_ms)
+			break;
+		board = *b;
+		paths = *pc;
+		player = id_player;
+		n = 0;
+		len = 0;
+		way[len++] = 0;
+		/* #2 SELECTION: DOWN THE TREE, TO A LEAF */
+		while(m->node[n].children && len < MCTS_MAX_DEPTH) {
+			n = select_child(m, n);
+			if(m->node[n].move != MOVE_NONE)
+				board_play(&board, &paths, m->node[n].move);
+			player = 3 - player;
+			way[len++] = n;
+		}
+		/* #3 EXPANSION OF A LEAF ALREADY VISITED: ITS FIRST CHILD IS PLAYED */
+		winner = board_winner(&board);
+		if(!winner && m->node[n].visits && !m->node[n].children && len < MCTS_MAX_DEPTH
+				&& expand(m, n, &board, &paths, player)) {
+			n = m->node[n].child;
+			if(m->node[n].move != MOVE_NONE)
+				board_play(&board, &paths, m->node[n].move);
+			player = 3 - player;
+			way[len++] = n;
+			winner = board_winner(&board);
+		}
+		/* #4 ROLLOUT */
+		length = m->rollout_plies;
+		if(!winner)
+			winner = mcts_rollout(&board, &paths, player, &m->seed, &m->rollout_plies);
+		length = len - 1 + m->rollout_plies - length;
+		loss = length < LENGTH_POINTS ? length : LENGTH_POINTS;
+		win = WIN_POINTS - loss;
+		/* #5 BACKPROPAGATION: THE MOVE OF way[i] IS OF id_player FOR ODD i */
+		for(i = 0; i < (uint32_t) len; i++) {
+			mover = i & 1 ? id_player : 3 - id_player;
+			m->node[way[i]].visits++;
+			m->node[way[i]].score += winner == mover ? win : winner == 0 ? WIN_POINTS / 2 : loss;
+		}
+		m->done++;
+	}
+	/* #6 MOST VISITED MOVE OF THE ROOT */
+	n = root->child;
+	for(i = 1; i < root->children; i++)
+		if(m->node[root->child + i].visits > m->node[n].visits)
+			n = root->child + i;
+	m->best = m->node[n].move;
+	if(m->node[n].visits)
+		m->win_rate = (int) ((uint64_t) m->node[n].score * 100 / WIN_POINTS / m->node[n].visits);
+	return m->best;
+}
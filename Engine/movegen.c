@@ -0,0 +1,229 @@
+#include <string.h>
+#include "Engine.h"
+
+/**
+ * @brief Legal moves of a token: steps in the four directions and face to
+ * face jumps. Nothing is drawn and no global is changed.
+ *
+ * @param b  The board.
+ * @param id_player  The id of the player (1 or 2).
+ * @param list  The list to be filled (previous moves are discarded).
+ *
+ * @return The number of moves, in the order DOWN, LEFT, RIGHT, UP.
+ */
+int board_gen_pawn_moves(const Board *b, int id_player, MoveList *list) {
+	int dir, dest, sq = b->pawn[id_player - 1];
+
+	list->count = 0;
+	for(dir = 0; dir < 4; dir++) {
+		dest = board_step(b, sq, dir);
+		if(dest != NO_SQUARE)
+			list->move[list->count++] = MOVE_PAWN(id_player, dest);
+	}
+	return list->count;
+}
+
+/**
+ * @brief All the legal moves of a player: token moves first, then wall
+ * placements (horizontal, then vertical).
+ *
+ * @details A wall is legal if the player has still walls, the slot does not
+ * conflict with the walls on the board and no player gets trapped. The trap
+ * check goes through the cache of the shortest paths if given (only its
+ * counters change), through a flood fill otherwise.
+ *
+ * @param b  The board.
+ * @param pc  The cache of the shortest paths, up to date with the board (or NULL).
+ * @param id_player  The id of the player (1 or 2).
+ * @param list  The list to be filled (previous moves are discarded).
+ *
+ * @return The number of moves.
+ */
+int board_gen_moves(const Board *b, PathCache *pc, int id_player, MoveList *list) {
+	Bits free_slots;
+	int horizontal, slot, traps;
+
+	board_gen_pawn_moves(b, id_player, list);
+	if(b->walls[id_player - 1] <= 0)
+		return list->count;
+	for(horizontal = 1; horizontal >= 0; horizontal--)
+		for(free_slots = board_free_slots(b, horizontal); free_slots; free_slots &= free_slots - 1) {
+			slot = bit_scan(free_slots);
+			traps = pc ? path_cache_traps(pc, b, horizontal, slot) : board_trapped(b, horizontal, slot);
+			if(!traps)
+				list->move[list->count++] = MOVE_WALL(id_player, horizontal, slot);
+		}
+	return list->count;
+}
+
+/**
+ * @brief Moves of a player that only need the trap check to be legal: token
+ * moves first, then walls in the free slots (horizontal, then vertical).
+ *
+ * @details Same order of board_gen_moves, without the trap check, which is
+ * left to the caller (path_cache_traps or board_trapped), e.g. only for the
+ * walls actually tried by a search before a cut-off.
+ *
+ * @param b  The board.
+ * @param id_player  The id of the player (1 or 2).
+ * @param list  The list to be filled (previous moves are discarded).
+ *
+ * @return The number of moves.
+ */
+int board_gen_candidates(const Board *b, int id_player, MoveList *list) {
+	Bits free_slots;
+	int horizontal;
+
+	board_gen_pawn_moves(b, id_player, list);
+	if(b->walls[id_player - 1] <= 0)
+		return list->count;
+	for(horizontal = 1; horizontal >= 0; horizontal--)
+		for(free_slots = board_free_slots(b, horizontal); free_slots; free_slots &= free_slots - 1)
+			list->move[list->count++] = MOVE_WALL(id_player, horizontal, bit_scan(free_slots));
+	return list->count;
+}
+
+/**
+ * @brief Play a move on the board and keep the cache of the shortest paths in sync.
+ *
+ * @details No legality check: the move should come from the generator.
+ *
+ * @param b  The board.
+ * @param pc  The cache of the shortest paths (or NULL).
+ * @param m  The move.
+ *
+ * @return Nothing
+ */
+void board_play(Board *b, PathCache *pc, Move m) {
+	int id_player = MOVE_PLAYER(m), sq = MOVE_SQUARE(m), from;
+
+	if(MOVE_IS_WALL(m)) {
+		board_place_wall(b, MOVE_HORIZONTAL(m), sq, id_player);
+		if(pc)
+			path_cache_place_wall(pc, b, MOVE_HORIZONTAL(m), sq);
+	} else {
+		from = b->pawn[id_player - 1];
+		board_set_pawn(b, id_player, sq);
+		if(pc)
+			path_cache_move_pawn(pc, b, id_player, from);
+	}
+}
+
+/**
+ * @brief Play a move and record what is needed to take it back (unmake_move).
+ *
+ * @details Same effect of board_play: the key and the cache of the shortest
+ * paths are updated incrementally. No copy of the board or of the cache is
+ * made: the undo record keeps the paths and, only for the players whose path
+ * is cut by a wall, the distances.
+ *
+ * @param b  The board.
+ * @param pc  The cache of the shortest paths (or NULL).
+ * @param m  The move (a legal one).
+ * @param u  The undo record to be filled.
+ *
+ * @return Nothing
+ */
+void make_move(Board *b, PathCache *pc, Move m, Undo *u) {
+	int p;
+
+	u->move = m;
+	u->from = b->pawn[MOVE_PLAYER(m) - 1];
+	if(pc) {
+		for(p = 0; p < 2; p++) {
+			u->path_s[p] = pc->path_s[p];
+			u->path_e[p] = pc->path_e[p];
+			u->length[p] = pc->length[p];
+		}
+		if(MOVE_IS_WALL(m)) {
+			u->saved = path_cache_cut(pc, MOVE_HORIZONTAL(m), MOVE_SQUARE(m));
+			for(p = 0; p < 2; p++) {
+				u->stale_h[p] = pc->stale_h[p];
+				u->stale_v[p] = pc->stale_v[p];
+				if(u->saved >> p & 1)
+					memcpy(u->dist[p], pc->dist[p], BOARD_SQUARES);
+			}
+		}
+	}
+	board_play(b, pc, m);
+}
+
+/**
+ * @brief Take back the last move played with make_move.
+ *
+ * @details Board and cache are restored exactly as they were (the counters of
+ * the cache excepted). The distances brought up to date by a token move are
+ * kept: they depend only on the walls. Only when they took in the wall being
+ * taken back (a player whose path the wall did not cut, then an update) they
+ * are computed again.
+ *
+ * @param b  The board.
+ * @param pc  The cache of the shortest paths (or NULL, as in make_move).
+ * @param u  The undo record filled by make_move.
+ *
+ * @return Nothing
+ */
+void unmake_move(Board *b, PathCache *pc, const Undo *u) {
+	int p;
+
+	if(MOVE_IS_WALL(u->move))
+		board_remove_wall(b, MOVE_HORIZONTAL(u->move), MOVE_SQUARE(u->move));
+	else
+		board_set_pawn(b, MOVE_PLAYER(u->move), u->from);
+	if(!pc)
+		return;
+	for(p = 0; p < 2; p++) {
+		pc->path_s[p] = u->path_s[p];
+		pc->path_e[p] = u->path_e[p];
+		pc->length[p] = u->length[p];
+		if(!MOVE_IS_WALL(u->move))
+			continue;
+		if(u->saved >> p & 1)
+			memcpy(pc->dist[p], u->dist[p], BOARD_SQUARES);
+		else if(!((MOVE_HORIZONTAL(u->move) ? pc->stale_h[p] : pc->stale_v[p]) >> MOVE_SQUARE(u->move) & 1)) {
+			path_cache_refresh(pc, b, p + 1);		/* THE WALL REACHED THE DISTANCES AFTER make_move */
+			continue;
+		}
+		pc->stale_h[p] = u->stale_h[p];
+		pc->stale_v[p] = u->stale_v[p];
+	}
+}
+
+/**
+ * @brief Number of positions reached after exactly 'depth' plies (perft).
+ *
+ * @details Every legal move is played with make_move and taken back, so the
+ * count checks the generator (face to face jumps, overlaps, traps) together
+ * with the incremental updates of the board and of the cache. A finished
+ * match has no moves; a player without legal moves passes (the pass is a
+ * ply). The moves of the last ply are counted, not played.
+ *
+ * @param b  The board (restored on return).
+ * @param pc  The cache of the shortest paths, up to date with the board (or NULL).
+ * @param id_player  The player to move (1 or 2).
+ * @param depth  The number of plies.
+ *
+ * @return The number of positions (leaves of the tree of the moves).
+ */
+uint64_t board_perft(Board *b, PathCache *pc, int id_player, int depth) {
+	MoveList list;
+	Undo u;
+	uint64_t nodes = 0;
+	int i;
+
+	if(depth == 0)
+		return 1;
+	if(board_winner(b))
+		return 0;
+	board_gen_moves(b, pc, id_player, &list);
+	if(!list.count)
+		return board_perft(b, pc, 3 - id_player, depth - 1);	/* PASS */
+	if(depth == 1)
+		return list.count;
+	for(i = 0; i < list.count; i++) {
+		make_move(b, pc, list.move[i], &u);
+		nodes += board_perft(b, pc, 3 - id_player, depth - 1);
+		unmake_move(b, pc, &u);
+	}
+	return nodes;
+}
@@ -0,0 +1,385 @@
+#include "Engine.h"
+
+/**
+ * @brief One step of the bit-parallel flood fill.
+ *
+ * @details Every reached square is expanded in the four directions at the same
+ * time, with shifts gated by the closed steps. A step down from sq is closed if
+ * bit sq of 'block_s' is set, a step up to sq if bit sq of 'block_s' is set
+ * (the step sq -> sq+7 is the same). Same for left/right and 'block_e'.
+ *
+ * @param reach  The squares reached so far.
+ * @param block_s  The closed steps down.
+ * @param block_e  The closed steps right.
+ *
+ * @return The squares reached with one more step.
+ */
+static __inline Bits flood_step(Bits reach, Bits block_s, Bits block_e) {
+	return reach
+		| ((reach & ~block_s & ~ROW_LAST) << BOARD_DIMENSION)	/* DOWN */
+		| ((reach >> BOARD_DIMENSION) & ~block_s)							/* UP */
+		| ((reach & ~block_e & ~COL_LAST) << 1)								/* RIGHT */
+		| ((reach >> 1) & ~block_e & ~COL_LAST);							/* LEFT */
+}
+
+/**
+ * @brief Squares reachable from a set of squares, walls taken into account.
+ *
+ * @param b  The board.
+ * @param from  The starting squares.
+ *
+ * @return The mask of the reachable squares (starting squares included).
+ */
+Bits board_reach(const Board *b, Bits from) {
+	Bits next = from, reach;
+	do {
+		reach = next;
+		next = flood_step(reach, b->block_s, b->block_e);
+	} while(next != reach);
+	return reach;
+}
+
+/**
+ * @brief Tests whether adding a wall in a slot traps one of the players.
+ *
+ * @details The board is not modified: the wall is added only to local copies
+ * of the closed steps. The squares reachable by the two players are expanded
+ * together until both reach their goal row (row 6 for player1, row 0 for
+ * player2) or until nothing changes anymore. Tokens never block a path.
+ *
+ * @param b  The board.
+ * @param horizontal  1 for an horizontal wall, 0 for a vertical one.
+ * @param slot  The slot of the wall to be tried.
+ *
+ * @return Bit 0 set if player1 is trapped, bit 1 set if player2 is trapped
+ * (0 if the wall can be inserted).
+ */
+int board_trapped(const Board *b, int horizontal, int slot) {
+	Bits s = BIT(slot), block_s = b->block_s, block_e = b->block_e;
+	Bits reach1 = BIT(b->pawn[0]), reach2 = BIT(b->pawn[1]), next1, next2;
+
+	/* #1 INSERT THE WALL IN THE LOCAL COPY OF THE CLOSED STEPS */
+	if(horizontal)
+		block_s |= s | s << 1;
+	else
+		block_e |= s | s << BOARD_DIMENSION;
+	/* #2 EXPAND UNTIL BOTH GOALS ARE REACHED OR NO NEW SQUARE IS FOUND */
+	for(;;) {
+		if((reach1 & ROW_LAST) && (reach2 & ROW_FIRST))
+			return 0;
+		next1 = flood_step(reach1, block_s, block_e);
+		next2 = flood_step(reach2, block_s, block_e);
+		if(next1 == reach1 && next2 == reach2)
+			break;
+		reach1 = next1;
+		reach2 = next2;
+	}
+	/* #3 A PLAYER THAT HAS NOT REACHED ITS GOAL ROW IS TRAPPED */
+	return (!(reach1 & ROW_LAST)) | (!(reach2 & ROW_FIRST)) << 1;
+}
+
+/* *******   CACHE OF THE SHORTEST PATHS   ****** */
+
+static const Bits goal_row[2] = {ROW_LAST, ROW_FIRST};	/* GOAL OF PLAYER1 AND PLAYER2 */
+
+/**
+ * @brief Tests whether a goal can be reached, with an early exit.
+ *
+ * @return 1 if at least one square of the goal is reachable, 0 otherwise.
+ */
+static int reaches_goal(Bits reach, Bits goal, Bits block_s, Bits block_e) {
+	Bits next;
+	while(!(reach & goal)) {
+		next = flood_step(reach, block_s, block_e);
+		if(next == reach)
+			return 0;
+		reach = next;
+	}
+	return 1;
+}
+
+/**
+ * @brief Masks of a single step between two adjacent squares, in the same
+ * format of 'block_s' and 'block_e' (both 0 if the squares are not adjacent).
+ */
+static void step_masks(int from, int to, Bits *step_s, Bits *step_e) {
+	*step_s = *step_e = 0;
+	if(to == from + BOARD_DIMENSION)
+		*step_s = BIT(from);
+	else if(to == from - BOARD_DIMENSION)
+		*step_s = BIT(to);
+	else if(to == from + 1)
+		*step_e = BIT(from);
+	else if(to == from - 1)
+		*step_e = BIT(to);
+}
+
+/**
+ * @brief Distances of all the squares from the goal row of a player.
+ *
+ * @details Breadth first search by layers: each layer is found with one
+ * flood fill step from the squares already reached.
+ */
+static void compute_dist(PathCache *pc, const Board *b, int p) {
+	Bits reach = goal_row[p], frontier = reach, next, m;
+	int sq, d = 0;
+
+	for(sq = 0; sq < BOARD_SQUARES; sq++)
+		pc->dist[p][sq] = PATH_UNREACHABLE;
+	pc->stale_h[p] = pc->stale_v[p] = 0;
+	while(frontier) {
+		for(m = frontier; m; m &= m - 1)
+			pc->dist[p][bit_scan(m)] = d;
+		next = flood_step(reach, b->block_s, b->block_e);
+		frontier = next & ~reach;
+		reach = next;
+		d++;
+	}
+}
+
+/**
+ * @brief Shortest path from the token of a player, following decreasing distances.
+ */
+static void trace_path(PathCache *pc, const Board *b, int p) {
+	const uint8_t *dist = pc->dist[p];
+	Bits step_s, step_e;
+	int sq = b->pawn[p], dir, next = sq;
+
+	pc->path_s[p] = pc->path_e[p] = 0;
+	pc->length[p] = dist[sq];
+	if(dist[sq] == PATH_UNREACHABLE)
+		return;
+	while(dist[sq] > 0) {
+		for(dir = 0; dir < 4; dir++) {
+			if(board_closed(b, dir) >> sq & 1)
+				continue;
+			next = sq + step_offset[dir];
+			if(dist[next] == dist[sq] - 1)
+				break;
+		}
+		step_masks(sq, next, &step_s, &step_e);
+		pc->path_s[p] |= step_s;
+		pc->path_e[p] |= step_e;
+		sq = next;
+	}
+}
+
+/**
+ * @brief Build the cache from scratch (distances and shortest paths of both players).
+ *
+ * @param pc  The cache.
+ * @param b  The board, with both tokens on it.
+ *
+ * @return Nothing
+ */
+void path_cache_init(PathCache *pc, const Board *b) {
+	int p;
+	for(p = 0; p < 2; p++) {
+		compute_dist(pc, b, p);
+		trace_path(pc, b, p);
+	}
+	pc->hits = pc->misses = 0;
+}
+
+/**
+ * @brief Players whose cached shortest path is cut by a wall in a slot.
+ *
+ * @param pc  The cache.
+ * @param horizontal  1 for an horizontal wall, 0 for a vertical one.
+ * @param slot  The slot of the wall.
+ *
+ * @return Bit 0 set if the path of player1 is cut, bit 1 for player2.
+ */
+int path_cache_cut(const PathCache *pc, int horizontal, int slot) {
+	Bits s = BIT(slot);
+	int p, cut = 0;
+	for(p = 0; p < 2; p++)
+		if(horizontal ? (s | s << 1) & pc->path_s[p] : (s | s << BOARD_DIMENSION) & pc->path_e[p])
+			cut |= 1 << p;
+	return cut;
+}
+
+/**
+ * @brief Tests whether adding a wall in a slot traps one of the players.
+ *
+ * @details Same result of board_trapped. If the wall closes no step of the
+ * cached shortest path of a player, the path is still there and the player
+ * cannot be trapped (hit). Otherwise a flood fill is needed (miss).
+ *
+ * @param pc  The cache, up to date with the board.
+ * @param b  The board.
+ * @param horizontal  1 for an horizontal wall, 0 for a vertical one.
+ * @param slot  The slot of the wall to be tried.
+ *
+ * @return Bit 0 set if player1 is trapped, bit 1 set if player2 is trapped.
+ */
+int path_cache_traps(PathCache *pc, const Board *b, int horizontal, int slot) {
+	Bits s = BIT(slot), cut_s = 0, cut_e = 0;
+	int p, traps = 0;
+
+	if(horizontal)
+		cut_s = s | s << 1;
+	else
+		cut_e = s | s << BOARD_DIMENSION;
+	for(p = 0; p < 2; p++) {
+		if(!(cut_s & pc->path_s[p]) && !(cut_e & pc->path_e[p])) {
+			pc->hits++;
+			continue;
+		}
+		pc->misses++;
+		if(!reaches_goal(BIT(b->pawn[p]), goal_row[p], b->block_s | cut_s, b->block_e | cut_e))
+			traps |= 1 << p;
+	}
+	return traps;
+}
+
+/**
+ * @brief Bring the distances of a player up to date with the walls placed
+ * since the last update ('stale_h' and 'stale_v'), only where they can grow.
+ *
+ * @details Distances only grow, and only for the squares whose shortest paths
+ * all go through a closed step: a step between squares at the same distance is
+ * on no shortest path, so nothing changes if every closed step is such. The
+ * squares nearer to the goal row than the far end of the nearest closed step
+ * that was on a shortest path keep their distance: they are reached again by
+ * flood fill steps without writing anything, and the breadth first search of
+ * compute_dist goes on from there, over the region behind the walls.
+ */
+static void update_dist(PathCache *pc, const Board *b, int p) {
+	uint8_t *dist = pc->dist[p];
+	Bits reach = goal_row[p], frontier, next, m;
+	int horizontal, step, sq, e, d, from = PATH_UNREACHABLE;
+
+	/* #1 NEAREST FAR END OF A CLOSED STEP THAT WAS ON A SHORTEST PATH */
+	for(horizontal = 0; horizontal < 2; horizontal++) {
+		step = horizontal ? BOARD_DIMENSION : 1;
+		for(m = horizontal ? pc->stale_h[p] : pc->stale_v[p]; m; m &= m - 1)
+			for(e = 0; e < 2; e++) {
+				sq = bit_scan(m) + (horizontal ? e : e * BOARD_DIMENSION);
+				if(dist[sq] == dist[sq + step] + 1 && dist[sq] < from)
+					from = dist[sq];
+				else if(dist[sq + step] == dist[sq] + 1 && dist[sq + step] < from)
+					from = dist[sq + step];
+			}
+	}
+	pc->stale_h[p] = pc->stale_v[p] = 0;
+	if(from == PATH_UNREACHABLE)
+		return;
+	/* #2 THE SQUARES THAT KEEP THEIR DISTANCE (LESS THAN 'from') */
+	for(d = 1; d < from; d++)
+		reach = flood_step(reach, b->block_s, b->block_e);
+	/* #3 THE OTHERS, LAYER BY LAYER */
+	for(d = from; ; d++) {
+		next = flood_step(reach, b->block_s, b->block_e);
+		frontier = next & ~reach;
+		if(!frontier)
+			break;
+		for(m = frontier; m; m &= m - 1)
+			dist[bit_scan(m)] = d;
+		reach = next;
+	}
+	for(m = SQUARES_MASK & ~reach; m; m &= m - 1)
+		dist[bit_scan(m)] = PATH_UNREACHABLE;	/* CLOSED OFF THE GOAL ROW */
+}
+
+/**
+ * @brief Update the cache after a wall has been inserted in the board.
+ *
+ * @details A player whose path is cut gets its distances updated where the
+ * wall makes them grow (update_dist) and a new path. For the other one the
+ * path is still a shortest one (walls never shorten paths): the wall is only
+ * noted, and its distances are updated when they are needed, together with
+ * those of the other walls noted in the meantime.
+ *
+ * @param pc  The cache.
+ * @param b  The board, with the new wall.
+ * @param horizontal  1 for an horizontal wall, 0 for a vertical one.
+ * @param slot  The slot of the new wall.
+ *
+ * @return Nothing
+ */
+void path_cache_place_wall(PathCache *pc, const Board *b, int horizontal, int slot) {
+	int p, cut = path_cache_cut(pc, horizontal, slot);
+
+	for(p = 0; p < 2; p++) {
+		if(horizontal)
+			pc->stale_h[p] |= BIT(slot);
+		else
+			pc->stale_v[p] |= BIT(slot);
+		if(cut >> p & 1) {
+			update_dist(pc, b, p);
+			trace_path(pc, b, p);
+		}
+	}
+}
+
+/**
+ * @brief Update the cache after the token of a player has moved.
+ *
+ * @details A single step along the cached path only shortens it. Any other
+ * move traces a new path from the distances (brought up to date first).
+ *
+ * @param pc  The cache.
+ * @param b  The board, with the token in the new square.
+ * @param id_player  The id of the player that has moved (1 or 2).
+ * @param from  The previous square of the token.
+ *
+ * @return Nothing
+ */
+void path_cache_move_pawn(PathCache *pc, const Board *b, int id_player, int from) {
+	int p = id_player - 1;
+	Bits step_s, step_e;
+
+	step_masks(from, b->pawn[p], &step_s, &step_e);
+	if((step_s & pc->path_s[p]) || (step_e & pc->path_e[p])) {
+		pc->path_s[p] &= ~step_s;
+		pc->path_e[p] &= ~step_e;
+		pc->length[p]--;
+		return;
+	}
+	update_dist(pc, b, p);
+	trace_path(pc, b, p);
+}
+
+/**
+ * @brief Distances of all the squares from the goal row of a player.
+ *
+ * @param pc  The cache.
+ * @param b  The board.
+ * @param id_player  The id of the player (1 or 2).
+ *
+ * @return The distances, up to date with the walls of the board (PATH_UNREACHABLE
+ * for a square closed off the goal row), valid until the next change of the cache.
+ */
+const uint8_t *path_cache_dist(PathCache *pc, const Board *b, int id_player) {
+	update_dist(pc, b, id_player - 1);
+	return pc->dist[id_player - 1];
+}
+
+/**
+ * @brief Distances of a player computed again from scratch (e.g. after a wall
+ * has been removed from the board). The path is not changed.
+ *
+ * @param pc  The cache.
+ * @param b  The board.
+ * @param id_player  The id of the player (1 or 2).
+ *
+ * @return Nothing
+ */
+void path_cache_refresh(PathCache *pc, const Board *b, int id_player) {
+	compute_dist(pc, b, id_player - 1);
+}
+
+/**
+ * @brief Percentage of the trap checks answered by the cache without a flood fill.
+ *
+ * @param pc  The cache.
+ *
+ * @return The hit rate, from 0 to 100 (100 if no check has been made).
+ */
+int path_cache_hit_rate(const PathCache *pc) {
+	uint32_t checks = pc->hits + pc->misses;
+	if(checks == 0)
+		return 100;
+	return (int) ((uint64_t) pc->hits * 100 / checks);
+}
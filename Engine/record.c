@@ -0,0 +1,224 @@
+#include "Engine.h"
+
+/* ***************   GAME RECORDS   *************** */
+/* Games are kept as a stream of bytes, one for each move (format in Engine.h).
+	 The Move word (same layout of 'mossa') is what goes in and out: the byte
+	 only drops the player, which the order of the moves already tells. A match
+	 of 40 plies takes 41 bytes, so hundreds of them fit in the RAM of the board. */
+
+#define WALL_SLOTS (WALL_DIMENSION * WALL_DIMENSION)
+
+/**
+ * @brief Byte of a move in the log.
+ *
+ * @param m  The move.
+ *
+ * @return The code, from 0 to LOG_PASS - 1.
+ */
+int log_encode(Move m) {
+	if(!MOVE_IS_WALL(m))
+		return MOVE_SQUARE(m);
+	return LOG_WALL_CODE + (MOVE_HORIZONTAL(m) ? WALL_SLOTS : 0) + MOVE_Y(m) * WALL_DIMENSION + MOVE_X(m);
+}
+
+/**
+ * @brief Move of a byte of the log (inverse of log_encode).
+ *
+ * @param code  The code, from 0 to LOG_PASS - 1.
+ * @param id_player  The player of the move (1 or 2).
+ *
+ * @return The move.
+ */
+Move log_decode(int code, int id_player) {
+	int horizontal;
+
+	if(code < LOG_WALL_CODE)
+		return MOVE_PAWN(id_player, code);
+	code -= LOG_WALL_CODE;
+	horizontal = code >= WALL_SLOTS;
+	if(horizontal)
+		code -= WALL_SLOTS;
+	return MOVE_WALL(id_player, horizontal, SQUARE(code / WALL_DIMENSION, code % WALL_DIMENSION));
+}
+
+/* ***************   WRITER   *************** */
+
+/**
+ * @brief Prepare an empty log on a buffer supplied by the caller.
+ *
+ * @param log  The log.
+ * @param buffer  The memory of the log.
+ * @param capacity  Its size in bytes (at least 1).
+ * @param sink  Function that takes the bytes when the buffer is full (NULL
+ * to keep only the games that fit in the buffer).
+ *
+ * @return Nothing
+ */
+void log_init(GameLog *log, uint8_t *buffer, uint32_t capacity, void (*sink)(const uint8_t *data, uint32_t length)) {
+	log->data = buffer;
+	log->capacity = capacity;
+	log->length = log->game_start = 0;
+	log->sink = sink;
+	log->side = 0;
+	log->dropped = 0;
+	log->games = log->lost = 0;
+}
+
+/**
+ * @brief Append a byte to the open game.
+ */
+static void log_put(GameLog *log, int code) {
+	if(log->dropped)
+		return;
+	if(log->length == log->capacity) {
+		if(!log->sink) {
+			/* NO ROOM: THE WHOLE GAME IS DROPPED, THE CLOSED ONES ARE KEPT */
+			log->length = log->game_start;
+			log->dropped = 1;
+			return;
+		}
+		log->sink(log->data, log->length);
+		log->length = log->game_start = 0;
+	}
+	log->data[log->length++] = (uint8_t) code;
+}
+
+/**
+ * @brief Open a new game (player1 moves first). A game still open is closed
+ * as unfinished.
+ *
+ * @param log  The log.
+ *
+ * @return Nothing
+ */
+void log_begin_game(GameLog *log) {
+	if(log->side)
+		log_end_game(log, 0);
+	log->side = 1;
+	log->dropped = 0;
+	log->game_start = log->length;
+}
+
+/**
+ * @brief Append a move to the open game (opened if needed). A move of the
+ * player who just moved means that the other one passed.
+ *
+ * @param log  The log.
+ * @param m  The move.
+ *
+ * @return Nothing
+ */
+void log_move(GameLog *log, Move m) {
+	if(!log->side)
+		log_begin_game(log);
+	if(MOVE_PLAYER(m) != log->side)
+		log_put(log, LOG_PASS);
+	log_put(log, log_encode(m));
+	log->side = 3 - MOVE_PLAYER(m);
+}
+
+/**
+ * @brief Close the open game.
+ *
+ * @param log  The log.
+ * @param winner  The winner (1 or 2), 0 if the game was not finished.
+ *
+ * @return Nothing
+ */
+void log_end_game(GameLog *log, int winner) {
+	if(!log->side)
+		return;
+	log_put(log, LOG_END | winner);
+	if(log->dropped)
+		log->lost++;
+	else
+		log->games++;
+	log->side = 0;
+	log->dropped = 0;
+	log->game_start = log->length;
+}
+
+/**
+ * @brief Give all the bytes of the buffer to the sink (the open game goes on
+ * in the next chunk). Nothing happens without a sink.
+ *
+ * @param log  The log.
+ *
+ * @return Nothing
+ */
+void log_flush(GameLog *log) {
+	if(!log->sink || !log->length)
+		return;
+	log->sink(log->data, log->length);
+	log->length = log->game_start = 0;
+}
+
+/* ***************   READER   *************** */
+
+/**
+ * @brief Start reading a log from its first byte.
+ *
+ * @param r  The reader.
+ * @param data  The log (or its first chunk).
+ * @param length  Its length in bytes.
+ *
+ * @return Nothing
+ */
+void log_reader_init(LogReader *r, const uint8_t *data, uint32_t length) {
+	r->side = 1;
+	r->winner = 0;
+	r->games = r->moves = 0;
+	log_reader_feed(r, data, length);
+}
+
+/**
+ * @brief Go on reading with the next chunk of the log, after log_read
+ * returned LOG_READ_MORE.
+ *
+ * @param r  The reader.
+ * @param data  The chunk.
+ * @param length  Its length in bytes.
+ *
+ * @return Nothing
+ */
+void log_reader_feed(LogReader *r, const uint8_t *data, uint32_t length) {
+	r->data = data;
+	r->length = length;
+	r->pos = 0;
+}
+
+/**
+ * @brief Read the next move of the log.
+ *
+ * @param r  The reader.
+ * @param m  The move read (LOG_READ_MOVE only).
+ *
+ * @return LOG_READ_MOVE, LOG_READ_END at the end of a game (winner in
+ * 'r->winner', the next move opens a new game), LOG_READ_MORE at the end of
+ * the data, LOG_READ_BAD for a byte that is not a code of the format.
+ */
+int log_read(LogReader *r, Move *m) {
+	int code;
+
+	for(;;) {
+		if(r->pos == r->length)
+			return LOG_READ_MORE;
+		code = r->data[r->pos++];
+		if(code < LOG_PASS) {
+			*m = log_decode(code, r->side);
+			r->side = 3 - r->side;
+			r->moves++;
+			return LOG_READ_MOVE;
+		}
+		if(code == LOG_PASS) {
+			r->side = 3 - r->side;
+			continue;
+		}
+		if((code & ~3) != LOG_END || (code & 3) == 3)
+			return LOG_READ_BAD;
+		r->winner = code & 3;
+		r->side = 1;
+		r->games++;
+		return LOG_READ_END;
+	}
+}
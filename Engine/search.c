@@ -0,0 +1,349 @@
+#include "Engine.h"
+
+/* ***************   ALPHA-BETA SEARCH (COMPUTER PLAYER)   *************** */
+/* Negamax with alpha-beta pruning and iterative deepening, on the legal moves
+	 of board_gen_moves. Scores are always from the point of view of the player
+	 to move. The search plays and takes back moves (make_move, unmake_move) on
+	 a single copy of the caller's position, which is never changed. With a transposition table,
+	 positions reached again through another order of moves are not searched twice. */
+
+#define CHECK_CLOCK 1023		/* THE CLOCK IS READ EVERY 1024 NODES */
+#define SCORE_WON (SCORE_WIN - 1000)	/* SCORES BEYOND THIS ARE WINS OR LOSSES */
+
+/* FLAG SET BY ANOTHER THREAD (PARALLEL SEARCH ON THE HOST) */
+#if defined(__GNUC__)
+#define ABORTED(flag) __atomic_load_n(flag, __ATOMIC_RELAXED)
+#else
+#define ABORTED(flag) (*(flag))
+#endif
+
+/**
+ * @brief Score of a win or a loss as stored in the table: counted from the
+ * position, not from the root (the position may be found at another ply).
+ */
+static int score_to_tt(int score, int ply) {
+	if(score > SCORE_WON)
+		return score + ply;
+	if(score < -SCORE_WON)
+		return score - ply;
+	return score;
+}
+
+static int score_from_tt(int score, int ply) {
+	if(score > SCORE_WON)
+		return score - ply;
+	if(score < -SCORE_WON)
+		return score + ply;
+	return score;
+}
+
+/**
+ * @brief Static evaluation of a position.
+ *
+ * @details Difference between the shortest paths to the goal rows (row 6 for
+ * player1, row 0 for player2), plus a smaller bonus for the walls still
+ * available. Both come from the cache of the shortest paths, so no search is made.
+ *
+ * @param b  The board.
+ * @param pc  The cache of the shortest paths, up to date with the board.
+ * @param id_player  The player from whose point of view the score is given.
+ *
+ * @return The score (positive if the player is ahead).
+ */
+int search_evaluate(const Board *b, const PathCache *pc, int id_player) {
+	int me = id_player - 1, opp = 2 - id_player;
+	return SCORE_STEP * (pc->length[opp] - pc->length[me])
+		+ SCORE_WALL * (b->walls[me] - b->walls[opp]);
+}
+
+/**
+ * @brief Tests whether the time budget is over (the clock is read only every
+ * CHECK_CLOCK+1 nodes). The first depth is never interrupted, unless another
+ * thread aborts the search.
+ */
+static int out_of_time(Search *s) {
+	if(s->stop)
+		return 1;
+	if(s->abort && ABORTED(s->abort))
+		return s->stop = 1;
+	if(s->depth > 0 && s->budget_ms && s->clock_ms && (s->nodes & CHECK_CLOCK) == 0
+			&& s->clock_ms() - s->start_ms >= s->budget_ms)
+		s->stop = 1;
+	return s->stop;
+}
+
+/**
+ * @brief Ordering key of a move (the greater, the earlier it is searched).
+ *
+ * @details Token moves toward the goal row first, then walls that cut the
+ * shortest path of the opponent, then sideways token moves, then the
+ * remaining walls and last token moves away from the goal.
+ */
+static int order_key(const Board *b, const PathCache *pc, Move m) {
+	int p = MOVE_PLAYER(m) - 1, sq = MOVE_SQUARE(m), forward;
+	Bits s = BIT(sq);
+
+	if(!MOVE_IS_WALL(m)) {
+		forward = ROW_OF(sq) - ROW_OF(b->pawn[p]);
+		if(p == 1)
+			forward = -forward;
+		return forward > 0 ? 4 : forward == 0 ? 2 : 0;
+	}
+	if(MOVE_HORIZONTAL(m))
+		return ((s | s << 1) & pc->path_s[1 - p]) ? 3 : 1;
+	return ((s | s << BOARD_DIMENSION) & pc->path_e[1 - p]) ? 3 : 1;
+}
+
+/**
+ * @brief Sort the moves by decreasing ordering key (stable, the generator
+ * order is kept among equal keys). 'first' is moved in front if present.
+ */
+static void order_moves(const Board *b, const PathCache *pc, MoveList *list, Move first) {
+	int key[MAX_MOVES], i, j, k;
+	Move m;
+
+	for(i = 0; i < list->count; i++) {
+		m = list->move[i];
+		k = m == first ? 5 : order_key(b, pc, m);
+		for(j = i; j > 0 && key[j - 1] < k; j--) {
+			list->move[j] = list->move[j - 1];
+			key[j] = key[j - 1];
+		}
+		list->move[j] = m;
+		key[j] = k;
+	}
+}
+
+/**
+ * @brief Negamax with alpha-beta pruning.
+ *
+ * @details A player without legal moves (token boxed in, no walls left) passes.
+ * Board and cache are given back as they were received.
+ *
+ * @return The score of the position for 'id_player' (0 if the search was stopped).
+ */
+static int negamax(Search *s, Board *b, PathCache *pc, int id_player, int depth, int ply, int alpha, int beta) {
+	MoveList list;
+	Undo undo;
+	const TTEntry *e;
+	uint64_t key = 0;
+	Move m, tt_move = MOVE_NONE, best_move = MOVE_NONE;
+	int i, score, best = -SCORE_WIN, winner, alpha_start = alpha, legal = 0;
+
+	s->nodes++;
+	if(out_of_time(s))
+		return 0;
+	/* #1 END OF THE MATCH (THE EARLIER THE WIN, THE HIGHER THE SCORE) OR LEAF */
+	winner = board_winner(b);
+	if(winner)
+		return winner == id_player ? SCORE_WIN - ply : ply - SCORE_WIN;
+	if(depth == 0)
+		return search_evaluate(b, pc, id_player);
+	/* #2 POSITION ALREADY SEARCHED DEEP ENOUGH: ITS SCORE, OR AT LEAST ITS BEST MOVE */
+	if(s->tt) {
+		key = board_key(b, id_player);
+		e = tt_probe(s->tt, key);
+		if(e) {
+			tt_move = e->move;
+			score = score_from_tt(e->score, ply);
+			if(e->depth >= depth && ((e->flags & 3) == TT_EXACT
+					|| ((e->flags & 3) == TT_LOWER && score >= beta)
+					|| ((e->flags & 3) == TT_UPPER && score <= alpha)))
+				return score;
+		}
+	}
+	/* #3 CHILDREN, ORDERED. A WALL IS CHECKED FOR TRAPS ONLY WHEN ITS TURN COMES */
+	board_gen_candidates(b, id_player, &list);
+	order_moves(b, pc, &list, tt_move);
+	for(i = 0; i < list.count; i++) {
+		m = list.move[i];
+		if(MOVE_IS_WALL(m) && path_cache_traps(pc, b, MOVE_HORIZONTAL(m), MOVE_SQUARE(m)))
+			continue;
+		legal++;
+		make_move(b, pc, m, &undo);
+		score = -negamax(s, b, pc, 3 - id_player, depth - 1, ply + 1, -beta, -alpha);
+		unmake_move(b, pc, &undo);
+		if(s->stop)
+			return 0;
+		if(score > best) {
+			best = score;
+			best_move = m;
+		}
+		if(score > alpha)
+			alpha = score;
+		if(alpha >= beta)
+			break;		/* CUT-OFF */
+	}
+	if(!legal)
+		return -negamax(s, b, pc, 3 - id_player, depth - 1, ply + 1, -beta, -alpha);	/* PASS */
+	if(s->tt)
+		tt_store(s->tt, key, depth, best >= beta ? TT_LOWER : best > alpha_start ? TT_EXACT : TT_UPPER,
+			score_to_tt(best, ply), best > alpha_start ? best_move : MOVE_NONE);
+	return best;
+}
+
+/**
+ * @brief Prepare a search with default limits: depth SEARCH_MAX_DEPTH, no
+ * time budget and no transposition table. The caller may then change
+ * max_depth, budget_ms, clock_ms and tt (abort and helper for a parallel search).
+ *
+ * @param s  The search.
+ *
+ * @return Nothing
+ */
+void search_init(Search *s) {
+	s->max_depth = SEARCH_MAX_DEPTH;
+	s->budget_ms = 0;
+	s->clock_ms = 0;
+	s->tt = 0;
+	s->best = MOVE_NONE;
+	s->score = s->depth = 0;
+	s->nodes = 0;
+	s->start_ms = 0;
+	s->stop = 0;
+	s->abort = 0;
+	s->helper = 0;
+}
+
+/**
+ * @brief Root moves of a helper of a parallel search: the first one is kept,
+ * the others are rotated by the index of the helper, so that the threads do
+ * not all search the same moves at the same time.
+ */
+static void rotate_moves(MoveList *list, int helper) {
+	Move rotated[MAX_MOVES];
+	int n = list->count - 1, i;
+
+	if(n < 2)
+		return;
+	for(i = 0; i < n; i++)
+		rotated[i] = list->move[1 + (i + helper) % n];
+	for(i = 0; i < n; i++)
+		list->move[1 + i] = rotated[i];
+}
+
+/**
+ * @brief Best move of a player, by iterative deepening.
+ *
+ * @details Depths 1, 2, ... max_depth are searched in turn, each one starting
+ * from the best move of the previous one. When the time budget is over the
+ * current depth is abandoned: the result is the best move of the last depth
+ * completed, or a better one already proved at the interrupted depth (the
+ * previous best move is always searched first). Depth 1 is always completed,
+ * so a legal move is returned whenever there is one (a helper of a parallel
+ * search may be aborted before: its result is not used).
+ *
+ * @param s  The search, with its limits. On return 'best', 'score', 'depth'
+ * (last depth completed) and 'nodes' hold the results.
+ * @param b  The board (not modified).
+ * @param pc  The cache of the shortest paths, up to date with the board (not modified).
+ * @param id_player  The player to move (1 or 2).
+ *
+ * @return The best move, MOVE_NONE if the player has no legal move or the match is over.
+ */
+Move search_best_move(Search *s, const Board *b, const PathCache *pc, int id_player) {
+	Board board = *b;
+	PathCache paths = *pc;
+	MoveList list;
+	Undo undo;
+	Move best;
+	int depth, i, score, alpha;
+
+	s->best = MOVE_NONE;
+	s->score = s->depth = 0;
+	s->nodes = 0;
+	s->stop = 0;
+	s->start_ms = s->clock_ms ? s->clock_ms() : 0;
+	if(s->tt)
+		tt_new_search(s->tt);
+	if(board_winner(b) || !board_gen_moves(&board, &paths, id_player, &list))
+		return MOVE_NONE;
+	for(depth = 1 + (s->helper & 1); depth <= s->max_depth; depth++) {
+		order_moves(b, pc, &list, s->best);
+		if(s->helper)
+			rotate_moves(&list, s->helper);
+		alpha = -SCORE_WIN - 1;
+		best = MOVE_NONE;
+		for(i = 0; i < list.count; i++) {
+			make_move(&board, &paths, list.move[i], &undo);
+			score = -negamax(s, &board, &paths, 3 - id_player, depth - 1, 1, -SCORE_WIN - 1, -alpha);
+			unmake_move(&board, &paths, &undo);
+			if(s->stop)
+				break;
+			if(score > alpha) {
+				alpha = score;
+				best = list.move[i];
+			}
+		}
+		if(best != MOVE_NONE && (!s->stop || best != s->best)) {
+			s->best = best;
+			s->score = alpha;
+		}
+		if(s->stop)
+			break;
+		if(s->tt)
+			tt_store(s->tt, board_key(b, id_player), depth, TT_EXACT, score_to_tt(alpha, 0), best);
+		s->depth = depth;
+		if(alpha >= SCORE_WIN - depth)
+			break;	/* FORCED WIN FOUND, NO NEED TO LOOK DEEPER */
+	}
+	return s->best;
+}
+
+/* ***************   PONDERING   *************** */
+
+/**
+ * @brief Start to ponder on a position, the opponent of the computer to move.
+ *
+ * @param p  The pondering.
+ * @param b  The board (copied).
+ * @param pc  The cache of the shortest paths, up to date with the board (copied).
+ * @param id_player  The player to move (the opponent of the computer).
+ * @param tt  The transposition table of the computer player.
+ * @param clock_ms  The millisecond clock of the slices.
+ *
+ * @return Nothing
+ */
+void ponder_start(Ponder *p, const Board *b, const PathCache *pc, int id_player, TransTable *tt, uint32_t (*clock_ms)(void)) {
+	p->board = *b;
+	p->paths = *pc;
+	p->id_player = id_player;
+	search_init(&p->search);
+	p->search.tt = tt;
+	p->search.clock_ms = clock_ms;
+	p->search.abort = &p->abort;
+	p->depth = 0;
+	p->slices = p->nodes = 0;
+	p->abort = 0;
+}
+
+/**
+ * @brief One slice of pondering: the position one depth deeper than the last
+ * depth completed, within a time budget.
+ *
+ * @details A slice that runs out of time leaves in the table the subtrees it
+ * completed, so the next slice at the same depth goes on from there. All the
+ * slices of a pondering store with the same generation of the table.
+ *
+ * @param p  The pondering.
+ * @param budget_ms  The time budget of the slice.
+ *
+ * @return The last depth completed, -1 if the pondering is over (opponent moved,
+ * match over or maximum depth reached).
+ */
+int ponder_slice(Ponder *p, uint32_t budget_ms) {
+	TransTable *tt = p->search.tt;
+
+	if(p->abort || p->depth >= SEARCH_MAX_DEPTH || board_winner(&p->board))
+		return -1;
+	if(tt && p->slices)
+		tt->generation = (tt->generation - 1) & TT_GENERATION;	/* search_best_move STARTS A NEW ONE */
+	p->search.max_depth = p->depth + 1;
+	p->search.budget_ms = budget_ms;
+	search_best_move(&p->search, &p->board, &p->paths, p->id_player);
+	p->slices++;
+	p->nodes += p->search.nodes;
+	if(!p->search.stop)
+		p->depth = p->search.max_depth;	/* ALSO AFTER A FORCED WIN: THE NEXT SLICES ARE QUICK */
+	return p->depth;
+}
@@ -0,0 +1,49 @@
+#ifndef __INPUT_H
+#define __INPUT_H
+
+#include <stdint.h>
+#include "c_functions.h"
+
+/* ***************   INPUT EVENTS   *************** */
+/* The interrupt handlers only push one byte for each input into a ring
+	 (input_push: a few instructions, no drawing), the main loop drains it and
+	 plays the events on the match (input_drain -> input_dispatch), where the
+	 LCD can be written for as long as needed. The ring has one producer and one
+	 consumer and needs no lock: the producer alone writes 'head', the consumer
+	 alone writes 'tail'. On the board the producers are the RIT (joystick and
+	 buttons, debounced) and the turn timer: they must run at the same priority,
+	 so that they never preempt each other and act as a single producer. The
+	 pondering of the computer also runs in input_drain, while the ring is empty. */
+
+#define INPUT_QUEUE_SIZE 32		/* EVENTS (A POWER OF TWO) */
+#define TURN_SECONDS 20				/* TIME OF A TURN */
+#define INPUT_PONDER_SLICE_MS 50	/* PONDERING OF input_drain WITH THE RING EMPTY (WORST DELAY OF AN EVENT) */
+
+/* EVENTS */
+#define INPUT_TOUCH 1					/* TOUCH PANEL: START OF THE MATCH */
+#define INPUT_DOWN 2					/* JOYSTICK: TOKEN OR WALL PREVIEW */
+#define INPUT_LEFT 3
+#define INPUT_RIGHT 4
+#define INPUT_UP 5
+#define INPUT_SELECT 6				/* JOYSTICK PRESSED: PLACE THE WALL PREVIEW */
+#define INPUT_KEY1 7					/* WALL MODE ON AND OFF */
+#define INPUT_KEY2 8					/* ROTATE THE WALL PREVIEW */
+#define INPUT_TICK 9					/* ONE SECOND OF THE TURN TIMER */
+#define INPUT_EVENTS 10				/* CODES ARE BELOW THIS */
+
+typedef struct {
+	uint8_t event[INPUT_QUEUE_SIZE];
+	volatile uint32_t head;				/* EVENTS PUSHED (WRITTEN BY THE PRODUCER) */
+	volatile uint32_t tail;				/* EVENTS POPPED (WRITTEN BY THE CONSUMER) */
+	volatile uint32_t dropped;		/* EVENTS LOST WITH THE RING FULL (WRITTEN BY THE PRODUCER) */
+} InputQueue;
+
+extern InputQueue input_queue;	/* THE RING OF THE BOARD */
+
+void input_init(InputQueue *q);
+int input_push(InputQueue *q, int event);
+int input_pop(InputQueue *q);
+void input_dispatch(QuoridorGame *game, int event);
+int input_drain(InputQueue *q, QuoridorGame *game);
+
+#endif
@@ -0,0 +1,229 @@
+#include "GLCD/GLCD.h"
+#include "Input.h"
+#include "Probe/Probe.h"
+
+/* ORDER OF THE ACCESSES TO THE RING: THE EVENT IS WRITTEN BEFORE THE NEW 'head'
+	 IS SEEN, AND READ BEFORE THE NEW 'tail' IS SEEN (ITS BYTE CAN BE WRITTEN AGAIN) */
+#if defined(__GNUC__)
+#define PUBLISH(var, value) __atomic_store_n(&(var), (value), __ATOMIC_RELEASE)
+#define OBSERVE(var) __atomic_load_n(&(var), __ATOMIC_ACQUIRE)
+#else
+/* ARMCC ON THE CORTEX-M3: ONE CORE, ONLY THE COMPILER COULD REORDER THEM */
+#define PUBLISH(var, value) do { __memory_changed(); (var) = (value); } while(0)
+#define OBSERVE(var) (var)
+#endif
+
+InputQueue input_queue;
+
+/**
+ * @brief Empty ring, no event lost.
+ *
+ * @param q  The ring.
+ *
+ * @return Nothing
+ */
+void input_init(InputQueue *q) {
+	q->head = q->tail = 0;
+	q->dropped = 0;
+}
+
+/**
+ * @brief Append an event to the ring. Called by the producer only (an
+ * interrupt handler on the board): constant time, nothing else is touched.
+ *
+ * @param q  The ring.
+ * @param event  The event (INPUT_TOUCH ... INPUT_TICK).
+ *
+ * @return 1 if the event is in the ring, 0 if it was full (the event is lost
+ * and counted in 'dropped').
+ */
+int input_push(InputQueue *q, int event) {
+	uint32_t head = q->head;
+
+	if(head - OBSERVE(q->tail) >= INPUT_QUEUE_SIZE) {
+		q->dropped++;
+		return 0;
+	}
+	q->event[head % INPUT_QUEUE_SIZE] = (uint8_t) event;
+	PUBLISH(q->head, head + 1);
+	return 1;
+}
+
+/**
+ * @brief Oldest event of the ring, removed. Called by the consumer only (the
+ * main loop).
+ *
+ * @param q  The ring.
+ *
+ * @return The event, -1 if the ring is empty.
+ */
+int input_pop(InputQueue *q) {
+	uint32_t tail = q->tail;
+	int event;
+
+	if(tail == OBSERVE(q->head))
+		return -1;
+	event = q->event[tail % INPUT_QUEUE_SIZE];
+	PUBLISH(q->tail, tail + 1);
+	return event;
+}
+
+/* ***************   DISPATCHER   *************** */
+
+/**
+ * @brief Wall preview shown or hidden (KEY1): the highlight of the moves of the
+ * token goes away while the preview is on the board, and comes back after.
+ */
+static void toggle_wall_mode(QuoridorGame *game, int id_player) {
+	int row = id_player == 1 ? game->row_player1/2 : game->row_player2/2;
+	int col = id_player == 1 ? game->col_player1/2 : game->col_player2/2;
+
+	if(game->wall_mode) {
+		draw_wall(game->posx_wall, game->posy_wall, game->horizontal, Black);
+		if(game->is_previous_overlapped)
+			redraw_walls(game);
+		possible_moves(game, row, col, id_player == 1 ? Lavanda : Red);
+		game->wall_mode = 0;
+	} else if(game->board.walls[id_player - 1] > 0) {
+		possible_moves(game, row, col, Black);
+		game->is_overlapped = game->is_previous_overlapped = is_overlapped_wall(game, game->posx_wall, game->posy_wall);
+		draw_wall(game->posx_wall, game->posy_wall, game->horizontal, id_player == 1 ? Hazelnut : Violet);
+		game->wall_mode = 1;
+	}
+}
+
+/**
+ * @brief End of a turn (move made or time over): the other player starts its
+ * own, with the full time and the highlight of its moves. Nothing after a win.
+ */
+static void next_turn(QuoridorGame *game, int id_player) {
+	int next = 3 - id_player;
+
+	game->end_turn1 = game->end_turn2 = 0;
+	game->wall_mode = 0;
+	if(board_winner(&game->board)) {
+		game->start_match = 0;
+		return;
+	}
+	game->start_turn1 = next == 1;
+	game->start_turn2 = next == 2;
+	game->seconds = TURN_SECONDS;
+	show_timer(game->seconds);
+	if(next == 1)
+		possible_moves(game, game->row_player1/2, game->col_player1/2, Lavanda);
+	else
+		possible_moves(game, game->row_player2/2, game->col_player2/2, Red);
+}
+
+/**
+ * @brief Play an input event on a match: what the interrupt handlers did, now
+ * in the main loop.
+ *
+ * @details A touch starts a match when none is in progress. During a match the
+ * joystick moves the token of the player in turn (only where possible_moves
+ * allows it) or, in wall mode, the wall preview; SELECT places the preview if
+ * it overlaps no wall and traps no player, KEY1 switches the wall mode (only
+ * with walls left) and KEY2 rotates the preview. Each tick takes one second
+ * from the turn: at 0 the turn goes to the opponent. Other events are ignored.
+ *
+ * @param game  The match.
+ * @param event  The event.
+ *
+ * @return Nothing
+ */
+void input_dispatch(QuoridorGame *game, int event) {
+	int id_player = game->start_turn1 ? 1 : 2;
+
+	PROBE_BEGIN(PROBE_INPUT_DISPATCH);
+	if(!game->start_match) {
+		if(event == INPUT_TOUCH) {
+			new_match(game);
+			game->seconds = TURN_SECONDS;
+			show_timer(game->seconds);
+		}
+	} else {
+		switch(event) {
+			case INPUT_DOWN:
+				if(game->wall_mode)
+					move_down_wall(game, id_player);
+				else if(game->possible_down)
+					move_down_token(game, id_player);
+				break;
+			case INPUT_LEFT:
+				if(game->wall_mode)
+					move_left_wall(game, id_player);
+				else if(game->possible_left)
+					move_left_token(game, id_player);
+				break;
+			case INPUT_RIGHT:
+				if(game->wall_mode)
+					move_right_wall(game, id_player);
+				else if(game->possible_right)
+					move_right_token(game, id_player);
+				break;
+			case INPUT_UP:
+				if(game->wall_mode)
+					move_up_wall(game, id_player);
+				else if(game->possible_up)
+					move_up_token(game, id_player);
+				break;
+			case INPUT_SELECT:
+				if(game->wall_mode && !game->is_overlapped) {
+					position_wall(game, id_player);
+					if(game->end_turn1 || game->end_turn2)
+						show_update_wall(id_player, game->board.walls[id_player - 1]);
+				}
+				break;
+			case INPUT_KEY1:
+				toggle_wall_mode(game, id_player);
+				break;
+			case INPUT_KEY2:
+				if(game->wall_mode)
+					rotate_wall(game);
+				break;
+			case INPUT_TICK:
+				if(--game->seconds > 0) {
+					show_timer(game->seconds);
+					break;
+				}
+				/* TIME OVER: THE PREVIEW OR THE HIGHLIGHT GOES AWAY, THE TURN IS LOST */
+				if(game->wall_mode)
+					toggle_wall_mode(game, id_player);
+				possible_moves(game, id_player == 1 ? game->row_player1/2 : game->row_player2/2,
+					id_player == 1 ? game->col_player1/2 : game->col_player2/2, Black);
+				game->end_turn1 = id_player == 1;
+				game->end_turn2 = id_player == 2;
+				break;
+			default:
+				break;
+		}
+		if(game->end_turn1 || game->end_turn2)
+			next_turn(game, id_player);
+	}
+	PROBE_END(PROBE_INPUT_DISPATCH);
+}
+
+/**
+ * @brief Play all the events in the ring (main loop). Events pushed meanwhile
+ * are played too.
+ *
+ * @details With the ring empty, the computer ponders for one slice of
+ * INPUT_PONDER_SLICE_MS (see computer_ponder): the search runs here, between
+ * events, and never in the interrupt handlers, whose work stays one push.
+ *
+ * @param q  The ring.
+ * @param game  The match.
+ *
+ * @return The number of events played.
+ */
+int input_drain(InputQueue *q, QuoridorGame *game) {
+	int event, count = 0;
+
+	while((event = input_pop(q)) >= 0) {
+		input_dispatch(game, event);
+		count++;
+	}
+	if(!count && game->start_match)
+		computer_ponder(game, INPUT_PONDER_SLICE_MS);
+	return count;
+}
@@ -0,0 +1,86 @@
+#ifndef __PROBE_H
+#define __PROBE_H
+
+#include <stdint.h>
+
+/* ***************   CYCLE PROBES   *************** */
+/* Named probes around the hot paths of a turn (drawing, walls, input). With
+	 PROBES defined, PROBE_BEGIN and PROBE_END read a free-running counter (the
+	 DWT cycle counter of the Cortex-M3, the TSC on an x86 host, else a
+	 nanosecond clock) and add the duration to the probe's entry of a static
+	 table: count, min, max, total and a histogram of powers of two. probe_init
+	 starts the counter (once, at startup), probe_dump prints the table one line
+	 at a time through a function given by the caller (LCD, UART, stdout).
+	 Without PROBES every macro is empty and nothing is compiled. A probe keeps a
+	 single start time: it must not nest with itself, nor run from an interrupt
+	 while the main loop is inside it. */
+
+#define PROBE_POSSIBLE_MOVES 0
+#define PROBE_IS_TRAPPOLA 1
+#define PROBE_IS_OVERLAPPED_WALL 2
+#define PROBE_POSITION_WALL 3
+#define PROBE_DRAW_BOARD 4
+#define PROBE_DRAW_PLAYER 5
+#define PROBE_DRAW_WALL 6
+#define PROBE_DRAW_SQUARE 7
+#define PROBE_INPUT_DISPATCH 8
+#define PROBE_COUNT 9
+
+#define PROBE_BUCKETS 24		/* BUCKET i: 2^i TO 2^(i+1) - 1 TICKS, THE LAST ONE ALSO ABOVE */
+
+#ifdef PROBES
+
+#if defined(__CC_ARM) || defined(__ARM_ARCH_7M__)
+/* DWT OF THE CORTEX-M3: CYCLE COUNTER, ENABLED WITH TRCENA OF THE DEMCR */
+#define PROBE_UNIT "cycles"
+#define DWT_CTRL (*(volatile uint32_t *) 0xE0001000)
+#define DWT_CYCCNT (*(volatile uint32_t *) 0xE0001004)
+#define CORE_DEMCR (*(volatile uint32_t *) 0xE000EDFC)
+static __inline uint32_t probe_clock(void) {
+	return DWT_CYCCNT;
+}
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROBE_UNIT "tsc ticks"
+static __inline uint32_t probe_clock(void) {
+	return (uint32_t) __rdtsc();
+}
+#else
+#include <time.h>
+#define PROBE_UNIT "ns"
+static __inline uint32_t probe_clock(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t) ts.tv_sec * 1000000000u + (uint32_t) ts.tv_nsec;
+}
+#endif
+
+typedef struct {
+	uint32_t start;						/* CLOCK AT PROBE_BEGIN */
+	uint32_t count, min, max;	/* DURATIONS IN TICKS OF probe_clock */
+	uint64_t total;
+	uint32_t histogram[PROBE_BUCKETS];
+} ProbeStats;
+
+extern ProbeStats probe_table[PROBE_COUNT];
+
+void probe_init(void);
+void probe_reset(void);
+void probe_record(ProbeStats *p, uint32_t ticks);
+void probe_dump(void (*print)(const char *line));
+
+/* DURATIONS MODULO 2^32: ONE SECOND OR MORE IS SHORTER ON THE HOST */
+#define PROBE_BEGIN(id) (probe_table[id].start = probe_clock())
+#define PROBE_END(id) probe_record(&probe_table[id], probe_clock() - probe_table[id].start)
+
+#else
+
+#define PROBE_BEGIN(id)
+#define PROBE_END(id)
+#define probe_init()
+#define probe_reset()
+#define probe_dump(print)
+
+#endif
+
+#endif
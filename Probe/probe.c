@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include "Probe.h"
+
+#ifdef PROBES
+
+ProbeStats probe_table[PROBE_COUNT];
+
+static const char *const probe_names[PROBE_COUNT] = {
+	"possible_moves", "is_trappola", "is_overlapped_wall", "position_wall",
+	"draw_board", "draw_player", "draw_wall", "draw_square", "input_dispatch"
+};
+
+/**
+ * @brief Start the counter (DWT on the board) and empty the table.
+ *
+ * @return Nothing
+ */
+void probe_init(void) {
+#if defined(__CC_ARM) || defined(__ARM_ARCH_7M__)
+	CORE_DEMCR |= 1u << 24;		/* TRCENA */
+	DWT_CYCCNT = 0;
+	DWT_CTRL |= 1;						/* CYCCNTENA */
+#endif
+	probe_reset();
+}
+
+/**
+ * @brief Forget every duration recorded.
+ *
+ * @return Nothing
+ */
+void probe_reset(void) {
+	int i, b;
+
+	for(i = 0; i < PROBE_COUNT; i++) {
+		probe_table[i].count = probe_table[i].max = 0;
+		probe_table[i].min = 0xFFFFFFFFu;
+		probe_table[i].total = 0;
+		for(b = 0; b < PROBE_BUCKETS; b++)
+			probe_table[i].histogram[b] = 0;
+	}
+}
+
+/**
+ * @brief Add a duration to a probe (PROBE_END).
+ *
+ * @param p  The entry of the probe.
+ * @param ticks  The duration.
+ *
+ * @return Nothing
+ */
+void probe_record(ProbeStats *p, uint32_t ticks) {
+	int b;
+
+	/* #1 BUCKET: POSITION OF THE HIGHEST BIT (CLZ ON THE CORTEX-M3) */
+#if defined(__GNUC__)
+	b = ticks ? 31 - __builtin_clz(ticks) : 0;
+#elif defined(__CC_ARM)
+	b = ticks ? 31 - (int) __clz(ticks) : 0;
+#else
+	for(b = 0; ticks >> b > 1; b++)
+		;
+#endif
+	if(b >= PROBE_BUCKETS)
+		b = PROBE_BUCKETS - 1;
+	/* #2 STATISTICS */
+	p->count++;
+	p->total += ticks;
+	if(ticks < p->min)
+		p->min = ticks;
+	if(ticks > p->max)
+		p->max = ticks;
+	p->histogram[b]++;
+}
+
+/**
+ * @brief Print the table: for each probe that ran, count, min, average and
+ * max, then the buckets of its histogram that are not empty (2^i: count).
+ *
+ * @param print  Writes one line (without the newline).
+ *
+ * @return Nothing
+ */
+void probe_dump(void (*print)(const char *line)) {
+	static char line[40 + 20 * PROBE_BUCKETS];
+	const ProbeStats *p;
+	int i, b, n;
+
+	sprintf(line, "%-20s %10s %10s %10s %10s  (%s)", "probe", "count", "min", "avg", "max", PROBE_UNIT);
+	print(line);
+	for(i = 0; i < PROBE_COUNT; i++) {
+		p = &probe_table[i];
+		if(!p->count)
+			continue;
+		sprintf(line, "%-20s %10lu %10lu %10lu %10lu", probe_names[i], (unsigned long) p->count,
+			(unsigned long) p->min, (unsigned long) (p->total / p->count), (unsigned long) p->max);
+		print(line);
+		n = sprintf(line, "%20s", "");
+		for(b = 0; b < PROBE_BUCKETS; b++)
+			if(p->histogram[b])
+				n += sprintf(line + n, " %s2^%d:%lu", b == PROBE_BUCKETS - 1 ? ">=" : "", b, (unsigned long) p->histogram[b]);
+		print(line);
+	}
+}
+
+#endif
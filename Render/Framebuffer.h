@@ -0,0 +1,38 @@
+#ifndef __FRAMEBUFFER_H
+#define __FRAMEBUFFER_H
+
+#include <stdint.h>
+#include "GLCD/GLCD.h"
+
+/* ***************   OFF-SCREEN FRAMEBUFFER   *************** */
+/* The whole 240x320 display in memory (RGB565, 150 KB: the host, or a board
+	 with external RAM). With FRAMEBUFFER defined, the files that include this
+	 header after GLCD.h (c_functions.c, render.c) draw into it through the same
+	 calls of the GLCD driver, renamed below. fb_flush copies the area changed
+	 since the last flush to the display with a single block write. */
+
+extern uint16_t fb_pixels[MAX_Y][MAX_X];
+
+void fb_clear(uint16_t color);
+uint16_t fb_get_point(uint16_t x, uint16_t y);
+void fb_set_point(uint16_t x, uint16_t y, uint16_t color);
+void fb_draw_line(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color);
+void fb_set_window(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+void fb_write_gram(const uint16_t *pixels, uint32_t count);
+void fb_put_char(uint16_t x, uint16_t y, uint8_t ascii, uint16_t color, uint16_t bk_color);
+void fb_text(uint16_t x, uint16_t y, uint8_t *str, uint16_t color, uint16_t bk_color);
+uint32_t fb_flush(void);
+void fb_flush_all(void);
+
+#if defined(FRAMEBUFFER) && !defined(FRAMEBUFFER_BACKEND)
+#define LCD_Clear fb_clear
+#define LCD_GetPoint fb_get_point
+#define LCD_SetPoint fb_set_point
+#define LCD_DrawLine fb_draw_line
+#define LCD_SetWindow fb_set_window
+#define LCD_WriteGRAM fb_write_gram
+#define PutChar fb_put_char
+#define GUI_Text fb_text
+#endif
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef __RENDER_H
+#define __RENDER_H
+
+#include <stdint.h>
+
+/* ***************   DIRTY-RECTANGLE RENDERER   *************** */
+/* Retained model of what is on the display: the 13x13 cells of the board
+	 (squares with their contour and token, spaces with walls) and a short list
+	 of items outside the board (lines and texts of the info panels). Drawing
+	 functions only change the model and mark the changed areas. At the end of a
+	 frame the areas are merged into rectangles and each rectangle is written
+	 once, as a single windowed block write (LCD_SetWindow + LCD_WriteGRAM) if
+	 the GLCD driver defines GLCD_HAS_WINDOW, with one line per row and color
+	 otherwise. Enabled by RENDER_DIRTY (see c_functions.c). */
+
+#define RENDER_BOARD_END BOARD_END_PX	/* FIRST PIXEL AFTER THE BOARD (234 ON 7x7, SEE Sprites.h) */
+#define RENDER_ITEMS 32					/* LINES AND TEXTS OUTSIDE THE BOARD */
+#define RENDER_RECTS 32					/* DIRTY RECTANGLES OF A FRAME */
+#define RENDER_TEXT_LENGTH 8
+
+typedef struct {
+	int16_t x0, y0, x1, y1;		/* INCLUSIVE */
+} RenderRect;
+
+typedef struct {
+	uint32_t frames;					/* FLUSHES WITH SOMETHING TO WRITE */
+	uint32_t rects;						/* RECTANGLES WRITTEN */
+	uint32_t pixels;					/* PIXELS WRITTEN */
+	uint32_t transactions;		/* BLOCK WRITES, OR LINES WITHOUT GLCD_HAS_WINDOW */
+} RenderStats;
+
+extern RenderStats render_stats;	/* TOTALS SINCE render_init */
+extern RenderStats render_frame;	/* LAST FRAME FLUSHED */
+
+void render_init(void);
+void render_begin(void);
+void render_end(void);
+void render_flush(void);
+
+/* BOARD (ROW AND COL FROM 0 TO 6, i AND j FROM 0 TO 12 AS IN color_spaces13x13) */
+void render_square(int row, int col, uint16_t color);
+void render_square_edge(int row, int col);
+void render_player(int row, int col, uint16_t color);
+void render_space(int i, int j, uint16_t color);
+void render_wall(int posx, int posy, int horizontal, uint16_t color);
+
+/* OUTSIDE THE BOARD */
+void render_line(int x0, int y0, int x1, int y1, uint16_t color);
+void render_fill(int x0, int y0, int x1, int y1, uint16_t color);
+void render_text(int x, int y, const char *str, uint16_t color, uint16_t bk_color);
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef __SPRITES_H
+#define __SPRITES_H
+
+#include <stdint.h>
+
+/* ***************   SPRITES AND GEOMETRY OF THE BOARD   *************** */
+/* Tables computed at compile time, shared by the drawing functions of
+	 c_functions.c and by the dirty-rectangle renderer: drawing a token, a wall
+	 or a space only reads them, with no arithmetic on the coordinates and no
+	 floating point (the Cortex-M3 has no FPU). */
+
+#if !defined(BOARD_DIMENSION) || BOARD_DIMENSION == 7
+#define BOARD_CELLS 13				/* CELLS OF THE 13x13 VIEW ON A ROW */
+#define SQUARE_PX 29					/* SIDE OF A SQUARE, CONTOUR INCLUDED */
+#define SPACE_PX 4						/* WIDTH OF A SPACE BETWEEN SQUARES */
+#define BOARD_START 7					/* FIRST PIXEL OF THE BOARD, BOTH AXES */
+#define TOKEN_CENTER 14				/* COLUMN OF THE AXIS OF THE TOKEN, IN ITS SQUARE */
+
+/* FIRST PIXEL AND SIZE OF EACH CELL OF THE 13x13 VIEW (SAME ON BOTH AXES):
+	 EVEN INDEXES ARE SQUARES, ODD INDEXES SPACES */
+static const uint8_t cell_start_px[BOARD_CELLS] = {
+	  7,  36,  40,  69,  73, 102, 106, 135, 139, 168, 172, 201, 205};
+static const uint8_t cell_size_px[BOARD_CELLS] = {
+	 29,   4,  29,   4,  29,   4,  29,   4,  29,   4,  29,   4,  29};
+
+/* TOKEN: HALF WIDTH OF EACH ROW (-1 IF EMPTY), FROM THE TOP OF THE SQUARE. A
+	 head (circle of radius 5 centered in (14, 9), rows 4 to 13) on a body
+	 (triangle from row 11, tip hidden in the head, to row 25). */
+static const int8_t token_half[SQUARE_PX] = {
+	-1, -1, -1, -1,  0,  3,  4,  4,  4,  5,  4,  4,  4,  3,  1,
+	 2,  2,  3,  3,  4,  4,  5,  5,  6,  6,  7, -1, -1, -1};
+
+#elif BOARD_DIMENSION == 9
+#define BOARD_CELLS 17				/* CELLS OF THE 17x17 VIEW ON A ROW */
+#define SQUARE_PX 22
+#define SPACE_PX 4
+#define BOARD_START 5
+#define TOKEN_CENTER 11
+
+static const uint8_t cell_start_px[BOARD_CELLS] = {
+	  5,  27,  31,  53,  57,  79,  83, 105, 109, 131, 135, 157, 161, 183, 187, 209, 213};
+static const uint8_t cell_size_px[BOARD_CELLS] = {
+	 22,   4,  22,   4,  22,   4,  22,   4,  22,   4,  22,   4,  22,   4,  22,   4,  22};
+
+/* TOKEN: head of radius 4 centered in (11, 7), rows 3 to 11, body to row 19 */
+static const int8_t token_half[SQUARE_PX] = {
+	-1, -1, -1,  0,  2,  3,  3,  4,  3,  3,  2,  1,
+	 2,  2,  3,  3,  4,  4,  5,  5, -1, -1};
+
+#else
+#error "no sprites for this BOARD_DIMENSION (7 or 9)"
+#endif
+
+#define PITCH_PX (SQUARE_PX + SPACE_PX)
+#define BOARD_END_PX (BOARD_START + BOARD_CELLS / 2 * PITCH_PX + SQUARE_PX)	/* FIRST PIXEL AFTER THE BOARD */
+
+#endif
@@ -0,0 +1,220 @@
+#include <string.h>
+#define FRAMEBUFFER_BACKEND		/* THE REAL DRIVER IS CALLED BY fb_flush */
+#include "GLCD/GLCD.h"
+#include "GLCD/AsciiLib.h"
+#include "Framebuffer.h"
+
+uint16_t fb_pixels[MAX_Y][MAX_X];
+
+/* AREA CHANGED SINCE THE LAST FLUSH (INCLUSIVE, EMPTY IF dirty_x0 > dirty_x1) */
+static int dirty_x0 = MAX_X, dirty_y0 = MAX_Y, dirty_x1 = -1, dirty_y1 = -1;
+
+/* WINDOW OF fb_set_window AND NEXT PIXEL OF fb_write_gram */
+static int win_x0, win_y0, win_x1 = MAX_X - 1, win_y1 = MAX_Y - 1, cur_x, cur_y;
+
+/**
+ * @brief Extend the changed area to a rectangle (already inside the display).
+ */
+static void mark(int x0, int y0, int x1, int y1) {
+	if(x0 < dirty_x0) dirty_x0 = x0;
+	if(y0 < dirty_y0) dirty_y0 = y0;
+	if(x1 > dirty_x1) dirty_x1 = x1;
+	if(y1 > dirty_y1) dirty_y1 = y1;
+}
+
+/**
+ * @brief Fill the framebuffer with a color (as LCD_Clear).
+ *
+ * @param color  The color.
+ *
+ * @return Nothing
+ */
+void fb_clear(uint16_t color) {
+	int i;
+	for(i = 0; i < MAX_X; i++)
+		fb_pixels[0][i] = color;
+	for(i = 1; i < MAX_Y; i++)
+		memcpy(fb_pixels[i], fb_pixels[0], sizeof(fb_pixels[0]));
+	mark(0, 0, MAX_X - 1, MAX_Y - 1);
+}
+
+uint16_t fb_get_point(uint16_t x, uint16_t y) {
+	return x < MAX_X && y < MAX_Y ? fb_pixels[y][x] : Black;
+}
+
+void fb_set_point(uint16_t x, uint16_t y, uint16_t color) {
+	if(x >= MAX_X || y >= MAX_Y)
+		return;
+	fb_pixels[y][x] = color;
+	mark(x, y, x, y);
+}
+
+/**
+ * @brief Line with both ends included (as LCD_DrawLine). Horizontal and
+ * vertical lines, the only ones drawn by the game, are written directly.
+ *
+ * @return Nothing
+ */
+void fb_draw_line(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color) {
+	int x, y, t, dx, dy, sx, sy, err, e2;
+
+	if(y0 == y1 && y0 < MAX_Y) {
+		if(x0 > x1) {
+			t = x0; x0 = x1; x1 = t;
+		}
+		if(x0 >= MAX_X)
+			return;
+		if(x1 >= MAX_X)
+			x1 = MAX_X - 1;
+		for(x = x0; x <= x1; x++)
+			fb_pixels[y0][x] = color;
+		mark(x0, y0, x1, y0);
+		return;
+	}
+	if(x0 == x1 && x0 < MAX_X) {
+		if(y0 > y1) {
+			t = y0; y0 = y1; y1 = t;
+		}
+		if(y0 >= MAX_Y)
+			return;
+		if(y1 >= MAX_Y)
+			y1 = MAX_Y - 1;
+		for(y = y0; y <= y1; y++)
+			fb_pixels[y][x0] = color;
+		mark(x0, y0, x0, y1);
+		return;
+	}
+	/* ANY OTHER LINE: BRESENHAM */
+	dx = x1 > x0 ? x1 - x0 : x0 - x1;
+	dy = y1 > y0 ? y0 - y1 : y1 - y0;
+	sx = x0 < x1 ? 1 : -1;
+	sy = y0 < y1 ? 1 : -1;
+	err = dx + dy;
+	x = x0;
+	y = y0;
+	for(;;) {
+		fb_set_point(x, y, color);
+		if(x == x1 && y == y1)
+			break;
+		e2 = 2 * err;
+		if(e2 >= dy) {
+			err += dy;
+			x += sx;
+		}
+		if(e2 <= dx) {
+			err += dx;
+			y += sy;
+		}
+	}
+}
+
+/**
+ * @brief Window of the next fb_write_gram calls (as LCD_SetWindow).
+ *
+ * @return Nothing
+ */
+void fb_set_window(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+	win_x0 = x0 < MAX_X ? x0 : MAX_X - 1;
+	win_y0 = y0 < MAX_Y ? y0 : MAX_Y - 1;
+	win_x1 = x1 < MAX_X ? x1 : MAX_X - 1;
+	win_y1 = y1 < MAX_Y ? y1 : MAX_Y - 1;
+	cur_x = win_x0;
+	cur_y = win_y0;
+	mark(win_x0, win_y0, win_x1, win_y1);
+}
+
+/**
+ * @brief Pixels written row by row inside the window, wrapping to its top
+ * (as LCD_WriteGRAM).
+ *
+ * @return Nothing
+ */
+void fb_write_gram(const uint16_t *pixels, uint32_t count) {
+	while(count--) {
+		fb_pixels[cur_y][cur_x] = *pixels++;
+		if(++cur_x > win_x1) {
+			cur_x = win_x0;
+			if(++cur_y > win_y1)
+				cur_y = win_y0;
+		}
+	}
+}
+
+/**
+ * @brief Character of the font 8x16 (as PutChar).
+ *
+ * @return Nothing
+ */
+void fb_put_char(uint16_t x, uint16_t y, uint8_t ascii, uint16_t color, uint16_t bk_color) {
+	uint8_t glyph[16];
+	int i, j;
+
+	GetASCIICode(glyph, ascii);
+	for(i = 0; i < 16; i++)
+		for(j = 0; j < 8; j++)
+			fb_set_point(x + j, y + i, (glyph[i] >> (7 - j)) & 1 ? color : bk_color);
+}
+
+/**
+ * @brief Text on a line, characters 8 pixels apart (as GUI_Text).
+ *
+ * @return Nothing
+ */
+void fb_text(uint16_t x, uint16_t y, uint8_t *str, uint16_t color, uint16_t bk_color) {
+	while(*str) {
+		fb_put_char(x, y, *str++, color, bk_color);
+		x += 8;
+	}
+}
+
+/**
+ * @brief Copy the area changed since the last flush to the display.
+ *
+ * @details With GLCD_HAS_WINDOW the area is a single block write, one
+ * LCD_WriteGRAM per row (one call for the whole area when it is as wide as
+ * the display). Otherwise each row is written with one LCD_DrawLine per run of
+ * a color.
+ *
+ * @return The number of pixels written.
+ */
+uint32_t fb_flush(void) {
+	int y, w, h;
+#ifndef GLCD_HAS_WINDOW
+	int x, start;
+#endif
+
+	if(dirty_x0 > dirty_x1)
+		return 0;
+	w = dirty_x1 - dirty_x0 + 1;
+	h = dirty_y1 - dirty_y0 + 1;
+#ifdef GLCD_HAS_WINDOW
+	LCD_SetWindow(dirty_x0, dirty_y0, dirty_x1, dirty_y1);
+	if(w == MAX_X)
+		LCD_WriteGRAM(fb_pixels[dirty_y0], (uint32_t) w * h);
+	else
+		for(y = dirty_y0; y <= dirty_y1; y++)
+			LCD_WriteGRAM(&fb_pixels[y][dirty_x0], w);
+#else
+	for(y = dirty_y0; y <= dirty_y1; y++)
+		for(start = dirty_x0, x = dirty_x0 + 1; x <= dirty_x1 + 1; x++)
+			if(x > dirty_x1 || fb_pixels[y][x] != fb_pixels[y][start]) {
+				LCD_DrawLine(start, y, x - 1, y, fb_pixels[y][start]);
+				start = x;
+			}
+#endif
+	dirty_x0 = MAX_X;
+	dirty_y0 = MAX_Y;
+	dirty_x1 = dirty_y1 = -1;
+	return (uint32_t) w * h;
+}
+
+/**
+ * @brief Copy the whole framebuffer to the display (after the display was
+ * changed by other means, e.g. at power on).
+ *
+ * @return Nothing
+ */
+void fb_flush_all(void) {
+	mark(0, 0, MAX_X - 1, MAX_Y - 1);
+	fb_flush();
+}
@@ -0,0 +1,452 @@
+#include <string.h>
+#include "GLCD/GLCD.h"
+#include "GLCD/AsciiLib.h"
+#include "Render.h"
+#include "Sprites.h"
+#ifdef FRAMEBUFFER
+#include "Framebuffer.h"
+#endif
+
+#define CELLS BOARD_CELLS
+#define MERGE_SLACK 64				/* PIXELS WORTH WRITING AGAIN TO SAVE A BLOCK WRITE */
+
+#define ITEM_LINE 1
+#define ITEM_FILL 2
+#define ITEM_TEXT 3
+
+typedef struct {
+	uint8_t type;
+	RenderRect box;
+	uint16_t color, bk_color;
+	char text[RENDER_TEXT_LENGTH + 1];
+} RenderItem;
+
+RenderStats render_stats;
+RenderStats render_frame;
+
+/* MODEL OF THE BOARD: FILL OF THE SQUARES AND COLOR OF THE SPACES, SQUARES WITH
+	 THEIR WHITE CONTOUR, SQUARES WITH A TOKEN (BIT col OF ROW row) */
+static uint16_t cell[CELLS][CELLS];
+static uint16_t edges[CELLS / 2 + 1], tokens[CELLS / 2 + 1];
+static uint16_t token_color[CELLS / 2 + 1][CELLS / 2 + 1];
+
+static RenderItem item[RENDER_ITEMS];
+static int items;
+
+static uint32_t dirty_cells[CELLS];		/* BIT j OF ROW i: CELL (i, j) CHANGED */
+static RenderRect dirty[RENDER_RECTS];
+static int rects;
+static int depth;		/* NESTED FRAMES (render_begin) */
+
+/* CELL OF THE 13x13 VIEW AND OFFSET IN IT OF EACH PIXEL OF THE BOARD (SAME ON
+	 BOTH AXES), FILLED FROM cell_start_px BEFORE THE FIRST WRITE */
+static uint8_t px_cell[RENDER_BOARD_END], px_offset[RENDER_BOARD_END];
+static int px_ready;
+
+/**
+ * @brief Add a rectangle to the dirty ones of the frame, merged with another
+ * one when few pixels are written twice or without need.
+ */
+static void add_rect(int x0, int y0, int x1, int y1) {
+	RenderRect r;
+	int i, area, merged;
+
+	if(x0 > x1 || y0 > y1)
+		return;
+	r.x0 = x0 < 0 ? 0 : x0;
+	r.y0 = y0 < 0 ? 0 : y0;
+	r.x1 = x1 >= MAX_X ? MAX_X - 1 : x1;
+	r.y1 = y1 >= MAX_Y ? MAX_Y - 1 : y1;
+	do {
+		merged = 0;
+		for(i = 0; i < rects; i++) {
+			RenderRect u = dirty[i];
+			if(r.x0 < u.x0) u.x0 = r.x0;
+			if(r.y0 < u.y0) u.y0 = r.y0;
+			if(r.x1 > u.x1) u.x1 = r.x1;
+			if(r.y1 > u.y1) u.y1 = r.y1;
+			area = (u.x1 - u.x0 + 1) * (u.y1 - u.y0 + 1);
+			if(area <= (dirty[i].x1 - dirty[i].x0 + 1) * (dirty[i].y1 - dirty[i].y0 + 1)
+					+ (r.x1 - r.x0 + 1) * (r.y1 - r.y0 + 1) + MERGE_SLACK) {
+				/* THE UNION TAKES THE PLACE OF BOTH, AND MAY NOW MERGE WITH OTHERS */
+				r = u;
+				dirty[i] = dirty[--rects];
+				merged = 1;
+				break;
+			}
+		}
+	} while(merged);
+	if(rects == RENDER_RECTS) {
+		/* FULL: THE LAST ONE GROWS TO INCLUDE THE NEW ONE */
+		RenderRect *u = &dirty[rects - 1];
+		if(r.x0 < u->x0) u->x0 = r.x0;
+		if(r.y0 < u->y0) u->y0 = r.y0;
+		if(r.x1 > u->x1) u->x1 = r.x1;
+		if(r.y1 > u->y1) u->y1 = r.y1;
+		return;
+	}
+	dirty[rects++] = r;
+}
+
+/**
+ * @brief Mark a cell of the 13x13 view as changed. Outside a frame the change
+ * is written at once.
+ */
+static void mark_cell(int i, int j) {
+	dirty_cells[i] |= (uint32_t) 1 << j;
+	if(!depth)
+		render_flush();
+}
+
+/* ***************   FRAMES   *************** */
+
+/**
+ * @brief Empty model (black display) and counters to 0.
+ *
+ * @return Nothing
+ */
+void render_init(void) {
+	memset(cell, 0, sizeof(cell));
+	memset(dirty_cells, 0, sizeof(dirty_cells));
+	memset(edges, 0, sizeof(edges));
+	memset(tokens, 0, sizeof(tokens));
+	items = rects = depth = 0;
+	memset(&render_stats, 0, sizeof(render_stats));
+	memset(&render_frame, 0, sizeof(render_frame));
+}
+
+/**
+ * @brief Open a frame: changes are only recorded until the matching render_end.
+ * Frames can be nested, only the outermost one writes.
+ *
+ * @return Nothing
+ */
+void render_begin(void) {
+	depth++;
+}
+
+/**
+ * @brief Close a frame. The outermost one writes all the changes.
+ *
+ * @return Nothing
+ */
+void render_end(void) {
+	if(depth > 0 && --depth == 0)
+		render_flush();
+}
+
+/**
+ * @brief Color of a pixel of the board in the model.
+ */
+static uint16_t board_pixel(int i, int oi, int j, int oj) {
+	int row = i >> 1, col = j >> 1, half;
+
+	if(!((i | j) & 1)) {
+		if((edges[row] >> col & 1) && (oi == 0 || oj == 0 || oi == SQUARE_PX - 1 || oj == SQUARE_PX - 1))
+			return White;
+		half = token_half[oi];
+		if((tokens[row] >> col & 1) && half >= 0 && oj >= TOKEN_CENTER - half && oj <= TOKEN_CENTER + half)
+			return token_color[row][col];
+	}
+	return cell[i][j];
+}
+
+/**
+ * @brief Pixels of a row of a rectangle: board (or background), then the
+ * items outside the board, in the order they were drawn.
+ */
+static void build_row(uint16_t *row, int y, int x0, int x1) {
+	uint8_t glyph[16];
+	int x, k, i = -1, oi = 0, n, bits;
+	const RenderItem *it;
+
+	/* #1 BOARD AND BACKGROUND */
+	if(y >= BOARD_START && y < RENDER_BOARD_END) {
+		i = px_cell[y];
+		oi = px_offset[y];
+	}
+	for(x = x0; x <= x1; x++) {
+		if(i < 0 || x < BOARD_START || x >= RENDER_BOARD_END) {
+			row[x - x0] = Black;
+			continue;
+		}
+		row[x - x0] = board_pixel(i, oi, px_cell[x], px_offset[x]);
+	}
+	/* #2 ITEMS CROSSING THE ROW */
+	for(k = 0; k < items; k++) {
+		it = &item[k];
+		if(y < it->box.y0 || y > it->box.y1 || x1 < it->box.x0 || x0 > it->box.x1)
+			continue;
+		for(x = x0 > it->box.x0 ? x0 : it->box.x0; x <= x1 && x <= it->box.x1; x++) {
+			if(it->type != ITEM_TEXT) {
+				row[x - x0] = it->color;
+				continue;
+			}
+			/* TEXT: FONT 8x16, MOST SIGNIFICANT BIT ON THE LEFT (AS PutChar) */
+			n = (x - it->box.x0) / 8;
+			if(x == x0 || (x - it->box.x0) % 8 == 0)
+				GetASCIICode(glyph, (uint8_t) it->text[n]);
+			bits = glyph[y - it->box.y0];
+			row[x - x0] = (bits >> (7 - (x - it->box.x0) % 8)) & 1 ? it->color : it->bk_color;
+		}
+	}
+}
+
+/**
+ * @brief Fill the cell and offset of each pixel of the board (once).
+ */
+static void pixel_map_init(void) {
+	int t, k;
+
+	for(t = 0; t < CELLS; t++)
+		for(k = 0; k < cell_size_px[t]; k++) {
+			px_cell[cell_start_px[t] + k] = t;
+			px_offset[cell_start_px[t] + k] = k;
+		}
+	px_ready = 1;
+}
+
+/**
+ * @brief Write a rectangle of the model on the display.
+ */
+static void write_rect(const RenderRect *r) {
+	uint16_t row[MAX_X];
+	int y, w = r->x1 - r->x0 + 1;
+#ifndef GLCD_HAS_WINDOW
+	int x, start;
+#endif
+
+#ifdef GLCD_HAS_WINDOW
+	LCD_SetWindow(r->x0, r->y0, r->x1, r->y1);
+	for(y = r->y0; y <= r->y1; y++) {
+		build_row(row, y, r->x0, r->x1);
+		LCD_WriteGRAM(row, w);
+	}
+	render_frame.transactions++;
+#else
+	/* NO WINDOWED WRITE IN THE DRIVER: ONE LINE FOR EACH RUN OF A COLOR */
+	for(y = r->y0; y <= r->y1; y++) {
+		build_row(row, y, r->x0, r->x1);
+		for(start = 0, x = 1; x <= w; x++)
+			if(x == w || row[x] != row[start]) {
+				LCD_DrawLine(r->x0 + start, y, r->x0 + x - 1, y, row[start]);
+				render_frame.transactions++;
+				start = x;
+			}
+	}
+#endif
+	render_frame.rects++;
+	render_frame.pixels += w * (r->y1 - r->y0 + 1);
+}
+
+/**
+ * @brief Write all the changes recorded since the last flush.
+ *
+ * @details Changed cells of the board become rectangles first (runs of cells
+ * on a row, extended down while the next row has the same run), then join the
+ * rectangles of the items. Each rectangle is written once.
+ *
+ * @return Nothing
+ */
+void render_flush(void) {
+	int open_j0[CELLS], open_j1[CELLS], open_i0[CELLS], open = 0;
+	int i, j, j1, k, n;
+	uint32_t row;
+
+	/* #1 CELLS -> RECTANGLES. A RECTANGLE STAYS OPEN WHILE THE NEXT ROW HAS THE SAME RUN */
+	for(i = 0; i <= CELLS; i++) {
+		row = i < CELLS ? dirty_cells[i] : 0;
+		for(k = n = 0; k < open; k++) {
+			j = open_j0[k];
+			j1 = open_j1[k];
+			if(((row >> j) & ((1 << (j1 - j + 1)) - 1)) == (1 << (j1 - j + 1)) - 1
+					&& (j == 0 || !(row >> (j - 1) & 1)) && !(row >> (j1 + 1) & 1)) {
+				row &= ~(((1 << (j1 - j + 1)) - 1) << j);		/* EXTENDED TO ROW i */
+				open_j0[n] = j;
+				open_j1[n] = j1;
+				open_i0[n++] = open_i0[k];
+			} else
+				add_rect(cell_start_px[j], cell_start_px[open_i0[k]], cell_start_px[j1] + cell_size_px[j1] - 1, cell_start_px[i - 1] + cell_size_px[i - 1] - 1);
+		}
+		open = n;
+		/* RUNS LEFT IN THE ROW OPEN NEW RECTANGLES */
+		for(j = 0; j < CELLS; j++)
+			if(row >> j & 1) {
+				for(j1 = j; j1 + 1 < CELLS && (row >> (j1 + 1) & 1); j1++)
+					;
+				open_j0[open] = j;
+				open_j1[open] = j1;
+				open_i0[open++] = i;
+				j = j1;
+			}
+		if(i < CELLS)
+			dirty_cells[i] = 0;
+	}
+	if(!rects)
+		return;
+	/* #2 WRITE */
+	if(!px_ready)
+		pixel_map_init();
+	memset(&render_frame, 0, sizeof(render_frame));
+	render_frame.frames = 1;
+	for(k = 0; k < rects; k++)
+		write_rect(&dirty[k]);
+	rects = 0;
+	render_stats.frames++;
+	render_stats.rects += render_frame.rects;
+	render_stats.pixels += render_frame.pixels;
+	render_stats.transactions += render_frame.transactions;
+}
+
+/* ***************   BOARD   *************** */
+
+/**
+ * @brief Full square of a color (contour and token are covered, as in draw_square).
+ *
+ * @return Nothing
+ */
+void render_square(int row, int col, uint16_t color) {
+	cell[2 * row][2 * col] = color;
+	edges[row] &= ~(1 << col);
+	tokens[row] &= ~(1 << col);
+	mark_cell(2 * row, 2 * col);
+}
+
+/**
+ * @brief White contour of a square.
+ *
+ * @return Nothing
+ */
+void render_square_edge(int row, int col) {
+	edges[row] |= 1 << col;
+	mark_cell(2 * row, 2 * col);
+}
+
+/**
+ * @brief Token of a color on a square.
+ *
+ * @return Nothing
+ */
+void render_player(int row, int col, uint16_t color) {
+	tokens[row] |= 1 << col;
+	token_color[row][col] = color;
+	mark_cell(2 * row, 2 * col);
+}
+
+/**
+ * @brief Color of a space of the 13x13 view (at least one index odd).
+ *
+ * @return Nothing
+ */
+void render_space(int i, int j, uint16_t color) {
+	cell[i][j] = color;
+	mark_cell(i, j);
+}
+
+/**
+ * @brief Wall of a color: 3 spaces of the 13x13 view (positions as in draw_wall).
+ *
+ * @return Nothing
+ */
+void render_wall(int posx, int posy, int horizontal, uint16_t color) {
+	int k;
+	render_begin();		/* THE 3 SPACES IN ONE FRAME */
+	for(k = 2; k <= 4; k++)
+		if(horizontal)
+			render_space(2 * posy + 1, 2 * posx + k, color);
+		else
+			render_space(2 * posy + k, 2 * posx + 1, color);
+	render_end();
+}
+
+/* ***************   OUTSIDE THE BOARD   *************** */
+
+/**
+ * @brief Add an item, in front of the others. An item with the same kind and
+ * position takes the place of the old one, opaque items (fills and texts)
+ * drop the items they cover completely.
+ */
+static void add_item(const RenderItem *it) {
+	int k, n = 0;
+
+	for(k = 0; k < items; k++) {
+		const RenderRect *b = &item[k].box;
+		int same = item[k].type == it->type && b->x0 == it->box.x0 && b->y0 == it->box.y0
+			&& (it->type == ITEM_TEXT || (b->x1 == it->box.x1 && b->y1 == it->box.y1));
+		int covered = it->type != ITEM_LINE && b->x0 >= it->box.x0 && b->y0 >= it->box.y0
+			&& b->x1 <= it->box.x1 && b->y1 <= it->box.y1;
+		if(same || covered)
+			add_rect(b->x0, b->y0, b->x1, b->y1);		/* ITS PIXELS MAY CHANGE */
+		else
+			item[n++] = item[k];
+	}
+	items = n;
+	if(items == RENDER_ITEMS) {
+		/* FULL: THE OLDEST ONE IS FORGOTTEN (ITS PIXELS STAY ON THE DISPLAY UNTIL COVERED) */
+		memmove(&item[0], &item[1], (RENDER_ITEMS - 1) * sizeof(RenderItem));
+		items--;
+	}
+	item[items++] = *it;
+	add_rect(it->box.x0, it->box.y0, it->box.x1, it->box.y1);
+	if(!depth)
+		render_flush();
+}
+
+/**
+ * @brief Horizontal or vertical line (as LCD_DrawLine, ends included).
+ *
+ * @return Nothing
+ */
+void render_line(int x0, int y0, int x1, int y1, uint16_t color) {
+	RenderItem it;
+	it.type = ITEM_LINE;
+	it.box.x0 = x0 < x1 ? x0 : x1;
+	it.box.x1 = x0 < x1 ? x1 : x0;
+	it.box.y0 = y0 < y1 ? y0 : y1;
+	it.box.y1 = y0 < y1 ? y1 : y0;
+	it.color = it.bk_color = color;
+	it.text[0] = 0;
+	add_item(&it);
+}
+
+/**
+ * @brief Full rectangle (corners included).
+ *
+ * @return Nothing
+ */
+void render_fill(int x0, int y0, int x1, int y1, uint16_t color) {
+	RenderItem it;
+	it.type = ITEM_FILL;
+	it.box.x0 = x0;
+	it.box.y0 = y0;
+	it.box.x1 = x1;
+	it.box.y1 = y1;
+	it.color = it.bk_color = color;
+	it.text[0] = 0;
+	add_item(&it);
+}
+
+/**
+ * @brief Text with the font 8x16 of GUI_Text (at most RENDER_TEXT_LENGTH characters).
+ *
+ * @return Nothing
+ */
+void render_text(int x, int y, const char *str, uint16_t color, uint16_t bk_color) {
+	RenderItem it;
+	int n = 0;
+	while(n < RENDER_TEXT_LENGTH && str[n]) {
+		it.text[n] = str[n];
+		n++;
+	}
+	if(!n)
+		return;
+	it.text[n] = 0;
+	it.type = ITEM_TEXT;
+	it.box.x0 = x;
+	it.box.y0 = y;
+	it.box.x1 = x + 8 * n - 1;
+	it.box.y1 = y + 15;
+	it.color = color;
+	it.bk_color = bk_color;
+	add_item(&it);
+}
@@ -1,22 +1,32 @@
 #include <stdio.h>
-#include <math.h>
 #include "GLCD/GLCD.h" 
 #include "TouchPanel/TouchPanel.h"
+#include "c_functions.h"
+#include "Render/Sprites.h"
+#include "Probe/Probe.h"
+#ifdef FRAMEBUFFER
+#include "Render/Framebuffer.h"		/* DRAWING GOES TO THE OFF-SCREEN FRAMEBUFFER */
+#endif
 
-#define BOARD_DIMENSION 7
-#define BOARD_DIM 13
+#ifdef RENDER_DIRTY
+/* DRAWING GOES THROUGH THE DIRTY-RECTANGLE RENDERER (Render/): THE CHANGES OF A
+	 GAMING FUNCTION ARE WRITTEN TOGETHER, AT ITS END (ONE FRAME) */
+#include "Render/Render.h"
+#define FRAME_BEGIN() render_begin()
+#define FRAME_END() render_end()
+#define PANEL_LINE(x0, y0, x1, y1, color) render_line(x0, y0, x1, y1, color)
+#define PANEL_TEXT(x, y, str, color, bk_color) render_text(x, y, str, color, bk_color)
+#else
+#define FRAME_BEGIN()
+#define FRAME_END()
+#define PANEL_LINE(x0, y0, x1, y1, color) LCD_DrawLine(x0, y0, x1, y1, color)
+#define PANEL_TEXT(x, y, str, color, bk_color) GUI_Text(x, y, (uint8_t *) (str), color, bk_color)
+#endif
 
-int board[BOARD_DIM][BOARD_DIM];
-int start_match, start_turn1, start_turn2, end_turn1, end_turn2;
-int row_player1, row_player2, col_player1, col_player2;		/* RATHER THAN A STRUCT */
-int f2f_down, f2f_left, f2f_right, f2f_up;	/* TOKENS FACE TO FACE */
-int posx_wall, posy_wall, horizontal, vertical, is_overlapped, is_previous_overlapped, is_out, trap1, trap2;
-volatile int possible_down = 1, possible_left = 1, possible_right = 1, possible_up = 1;
-extern int wall_mode;
-extern uint32_t mossa;
+QuoridorGame default_game;	/* THE MATCH PLAYED ON THE BOARD */
 
 /* ***************   DRAWING FUNCTIONS   *************** */
-/* *****   JUMP TO LINE 240 FOR GAMING FUNCTIONS   ***** */
+/* *****   JUMP TO "GAMING FUNCTIONS" BELOW   ***** */
 /**
  * @brief Clean (color black) a specific dispaly area.
  *	
@@ -27,35 +37,39 @@ extern uint32_t mossa;
  * @return Nothing
  */
 void clean_zone(int start_x, int start_y, int length) {
+#ifdef RENDER_DIRTY
+	render_fill(start_x, start_y, start_x + length, start_y + 29, Black);
+#else
 	int i;
 	for(i = 0; i < 30; i++) 	/* area 30 pixels high */
 		LCD_DrawLine(start_x, start_y + i, start_x + length, start_y + i, Black);
+#endif
 }
 
 /**
  * @brief Initialization of the Quoridor board.
  *
- * @details The board is modeled as a matrix 13x13 (on one row, 7 cells for
- * tokens, 6 cells for spaces). Tokens can occupy only cells with even row
- * and even column indexes. The remaining cells are occupied by walls. At
- * the beginning of the game, the entire board is initialized to 0. Subse-
- * quently the cells can take one of the following values (0 if free):
+ * @details The board is modeled as a bitboard (see Engine/Engine.h): tokens
+ * as square indexes, walls as masks of occupied slots. The matrix 13x13 of
+ * the first implementation (on one row, 7 cells for tokens, 6 cells for
+ * spaces) is still available as a derived view through 'board_cell'. Tokens
+ * occupy only cells with even row and even column indexes. The remaining
+ * cells are occupied by walls. The cells take one of the following values
+ * (0 if free):
  * 		1 	if player1 is present
  *		2 	if player2 is present
  * 		3 	if a wall of player1 is present
  * 		4 	if a wall of player2 is present
- * The distinction between walls does not appear necessary immediately, but
- * can be useful in future. It gives a precise representation of the situation.
+ * At the beginning of the game, the board is empty (no tokens, no walls).
+ * zobrist_init must have been called once at startup (see Engine.h).
  *
- * @param	No params
+ * @param game  The match.
  *
  * @return Nothing
  */
-void initialize_board(void) {
-	int i, j;
-	for(i = 0; i < BOARD_DIM; i++)
-		for(j = 0; j < BOARD_DIM; j++)
-			board[i][j] = 0;
+void initialize_board(QuoridorGame *game) {
+	board_init(&game->board);
+	game->possible_down = game->possible_left = game->possible_right = game->possible_up = 1;
 }
 
 /**
@@ -74,10 +88,17 @@ void initialize_board(void) {
  * @return Nothing
  */
 void draw_square_edge(int row, int col) {
-		LCD_DrawLine( 7+33*col,  7+33*row, 35+33*col,  7+33*row, White);
-		LCD_DrawLine(35+33*col,  7+33*row, 35+33*col, 35+33*row, White);
-		LCD_DrawLine(35+33*col, 35+33*row,  7+33*col, 35+33*row, White);
-		LCD_DrawLine( 7+33*col, 35+33*row,  7+33*col,  7+33*row, White);
+#ifdef RENDER_DIRTY
+	render_square_edge(row, col);
+#else
+	int x0 = cell_start_px[2*col], y0 = cell_start_px[2*row];
+	int x1 = x0 + SQUARE_PX - 1, y1 = y0 + SQUARE_PX - 1;
+
+	LCD_DrawLine(x0, y0, x1, y0, White);
+	LCD_DrawLine(x1, y0, x1, y1, White);
+	LCD_DrawLine(x1, y1, x0, y1, White);
+	LCD_DrawLine(x0, y1, x0, y0, White);
+#endif
 }
 
 /**
@@ -89,12 +110,16 @@ void draw_square_edge(int row, int col) {
  */
 void draw_board(void) {
 	int row, col;
+	PROBE_BEGIN(PROBE_DRAW_BOARD);
+	FRAME_BEGIN();
 	
 	for(row = 0; row < BOARD_DIMENSION; row++) {
 		for(col = 0; col < BOARD_DIMENSION; col++) {	
 			draw_square_edge(row, col);
 		}
 	}	
+	FRAME_END();
+	PROBE_END(PROBE_DRAW_BOARD);
 }
 
 /**
@@ -107,18 +132,20 @@ void draw_board(void) {
  */
 void show_info_layout(void) {
 	int col;
+	FRAME_BEGIN();
 	
 	/* DRAW 3 RECTANGLES (ONE NEXT TO THE OTHER) */
 	for(col = 0; col < 3; col++) {
-		LCD_DrawLine(10+75*col, 255, 80+75*col, 255, White);
-		LCD_DrawLine(80+75*col, 255, 80+75*col, 300, White);
-		LCD_DrawLine(80+75*col, 300, 10+75*col, 300, White);
-		LCD_DrawLine(10+75*col, 300, 10+75*col, 255, White);
+		PANEL_LINE(10+75*col, 255, 80+75*col, 255, White);
+		PANEL_LINE(80+75*col, 255, 80+75*col, 300, White);
+		PANEL_LINE(80+75*col, 300, 10+75*col, 300, White);
+		PANEL_LINE(10+75*col, 300, 10+75*col, 255, White);
 	}
 	
 	/* WRITE TITLES OF THE FIRST AND THIRD RECTANGLE */
-	GUI_Text(20, 260, (uint8_t *) "P1 Wall", White, Black);
-	GUI_Text(170, 260, (uint8_t *) "P2 Wall", Red, Black);
+	PANEL_TEXT(20, 260, "P1 Wall", White, Black);
+	PANEL_TEXT(170, 260, "P2 Wall", Red, Black);
+	FRAME_END();
 }
 
 /**
@@ -131,29 +158,29 @@ void show_info_layout(void) {
  * @return Nothing
  */
 void show_update_wall(int id_player, int walls) {
-	char walls_str[2] = "";
+	char walls_str[4] = "";
 	sprintf(walls_str, "%d", walls);
 	if(id_player == 1)
-		GUI_Text(45, 280, (uint8_t *) walls_str, White, Black);
+		PANEL_TEXT(45, 280, walls_str, White, Black);
 	else
-		GUI_Text(195, 280, (uint8_t *) walls_str, Red, Black);
+		PANEL_TEXT(195, 280, walls_str, Red, Black);
 }
 
 /**
- * @brief Write seconds in the middle rectangle of the layout.
+ * @brief Write the seconds left in the middle rectangle of the layout.
  *
- * @param	seconds  The number of seconds that have passed since
- * the start of the turn (from 1 to 20). Then turn of the opponent.
+ * @param	seconds  The number of seconds left in the turn, counted down
+ * from TURN_SECONDS (20) to 1. At 0 the turn goes to the opponent.
  *
  * @return Nothing
  */
 void show_timer(int seconds) {
-	char time_in_char[3] = "";
+	char time_in_char[8] = "";	/* UP TO "20 s" PLUS TERMINATOR */
 	sprintf(time_in_char, "%d s", seconds);
 	if(seconds < 10)
-		GUI_Text(110, 270, (uint8_t *) time_in_char, White, Black);
+		PANEL_TEXT(110, 270, time_in_char, White, Black);
 	else
-		GUI_Text(105, 270, (uint8_t *) time_in_char, White, Black);
+		PANEL_TEXT(105, 270, time_in_char, White, Black);
 }
 
 /**
@@ -162,7 +189,8 @@ void show_timer(int seconds) {
  * @details The row and column indexes vary from 0 to the size 
  * of the real board (7) minus 1. The 13x13 matrix is used for 
  * implementations reasons. For drawing tokens, indexes from 0 
- * to 7-1 are preferred. Token like a circle plus a triangle.
+ * to 7-1 are preferred. Token like a circle plus a triangle,
+ * drawn from the span table token_half (Render/Sprites.h).
  * 
  * @param	row  The row index in which to draw the token (player).
  * @param col  The column index in which to draw the token (player).
@@ -171,26 +199,20 @@ void show_timer(int seconds) {
  * @return Nothing
  */
 void draw_player(int row, int col, int color) {
-	int i;				/* VARIABLE FOR LOOP */
-	int x1, y1;		/* GENERIC COORDINATES OF CIRCLE */
-	
-	/* DRAW CIRCLE WITH HORIZONTAL LINES (RADIUS AND CENTER COORDINATES) */
-	int radius = 5;
-	double xc = 7 + 33*col + 14;
-	double yc = 7 + 33*row + 9;
-	
-	for(i = 0; i < 2 * radius; i++) {
-		y1 = yc - radius + i;
-		x1 = sqrt(radius * radius - (y1 - yc) * (y1 - yc));	/* (y1 - yc) to center on y */ 
-		LCD_DrawLine(xc - x1, y1, xc + x1, y1, color);
-	}
-	
-	/* DRAW TRIANGLE WITH HORIZONTAL LINES */
-	/* For aesthetic reasons, the tip of the triangle (token body) is hidden in the token
-		 head (-3 in y coordinates of LCD_Drawline) */
-	for(i = 0; i < 3 * radius; i++) {
-		LCD_DrawLine(xc - i/2, yc + radius + i - 3, xc + i/2, yc + radius + i - 3, color);
-	}
+#ifdef RENDER_DIRTY
+	PROBE_BEGIN(PROBE_DRAW_PLAYER);
+	render_player(row, col, color);
+#else
+	int line;
+	int xc = cell_start_px[2*col] + TOKEN_CENTER, y = cell_start_px[2*row];
+
+	PROBE_BEGIN(PROBE_DRAW_PLAYER);
+	/* ONE LINE FOR EACH ROW OF THE SPRITE (HEAD AND BODY, SEE Render/Sprites.h) */
+	for(line = 0; line < SQUARE_PX; line++)
+		if(token_half[line] >= 0)
+			LCD_DrawLine(xc - token_half[line], y + line, xc + token_half[line], y + line, color);
+#endif
+	PROBE_END(PROBE_DRAW_PLAYER);
 }
 
 /**
@@ -206,21 +228,34 @@ void draw_player(int row, int col, int color) {
  * 
  * @param	posx  The posx index in which to draw the wall.
  * @param posy  The posy index in which to draw the wall.
+ * @param horizontal  1 for an horizontal wall, 0 for a vertical one.
  * @param color  The color with which to draw the wall.
  *
  * @return Nothing
  */
-void draw_wall(int posx, int posy, int color) {
-	int line;
+void draw_wall(int posx, int posy, int horizontal, int color) {
+#ifdef RENDER_DIRTY
+	PROBE_BEGIN(PROBE_DRAW_WALL);
+	render_wall(posx, posy, horizontal, color);
+#else
+	int line, x, y;
+	PROBE_BEGIN(PROBE_DRAW_WALL);
 	if(horizontal) {
-		for(line = 0; line <= 3; line++)	/* wall width */
-			/* posx = 2 -> 3 squares + 3 spaces, posy = 3 -> 4 squares, 3 spaces */ 
-			LCD_DrawLine(7 + (posx+1)*33, 8 + (posy+1)*28 + posy*5 + line, 7 + (posx+1)*33 + 61, 8 + (posy+1)*28 + posy*5 + line, color);
+		/* posx = 2 -> 3 squares + 3 spaces, posy = 3 -> 4 squares, 3 spaces */
+		x = cell_start_px[2*posx + 2];
+		y = cell_start_px[2*posy + 1];
+		for(line = 0; line < SPACE_PX; line++)	/* wall width */
+			LCD_DrawLine(x, y + line, x + 2*SQUARE_PX + SPACE_PX - 1, y + line, color);
 	} else {
-		for(line = 0; line <= 28*2 + 5; line++)
-			LCD_DrawLine(8 + (posx+1)*28 + posx*5, 7 + (posy+1)*33 + line, 8 + (posx+1)*28 + posx*5 + 3, 7 + (posy+1)*33 + line, color);
+		/* VERTICAL LINES: 4 INSTEAD OF 62 HORIZONTAL ONES */
+		x = cell_start_px[2*posx + 1];
+		y = cell_start_px[2*posy + 2];
+		for(line = 0; line < SPACE_PX; line++)
+			LCD_DrawLine(x + line, y, x + line, y + 2*SQUARE_PX + SPACE_PX - 1, color);
 	}
-} 
+#endif
+	PROBE_END(PROBE_DRAW_WALL);
+}
 
 /**
  * @brief Draw full square, given the row and column indexes. 
@@ -232,353 +267,397 @@ void draw_wall(int posx, int posy, int color) {
  * @return Nothing
  */
 void draw_square(int row, int col, int color) {
+#ifdef RENDER_DIRTY
+	PROBE_BEGIN(PROBE_DRAW_SQUARE);
+	render_square(row, col, color);
+#else
 	int line;
+	int x = cell_start_px[2*col], y = cell_start_px[2*row];
 
-	for(line = 0; line < 29; line++)
-		LCD_DrawLine(7 + 33*col, 7 + 33*row + line, 7 + 33*col + 28, 7 + 33*row + line, color);
+	PROBE_BEGIN(PROBE_DRAW_SQUARE);
+	for(line = 0; line < SQUARE_PX; line++)
+		LCD_DrawLine(x, y + line, x + SQUARE_PX - 1, y + line, color);
+#endif
+	PROBE_END(PROBE_DRAW_SQUARE);
 }
 
 /* ***************   GAMING FUNCTIONS   *************** */
-/* *******   FOR TOKENS. JUMP TO 579 FOR WALLS   ****** */
+/**
+ * @brief Append a move to the record of the match, if any. The game is closed
+ * when the move wins it. The pondering, if any, is stopped: its position is gone.
+ */
+static void record_move(QuoridorGame *game, Move m) {
+	if(game->ponder)
+		game->ponder->abort = 1;
+	if(!game->log)
+		return;
+	log_move(game->log, m);
+	if(board_winner(&game->board))
+		log_end_game(game->log, board_winner(&game->board));
+}
+
+/**
+ * @brief Store in the bitboard the new position of a token (row_player and
+ * col_player) and update the cached shortest path of the player.
+ *
+ * @param game  The match.
+ * @param id_player  The id of the player that has moved.
+ *
+ * @return Nothing
+ */
+static void update_token(QuoridorGame *game, int id_player) {
+	int from = game->board.pawn[id_player - 1];
+	if(id_player == 1)
+		board_set_pawn(&game->board, 1, SQUARE(game->row_player1/2, game->col_player1/2));
+	else
+		board_set_pawn(&game->board, 2, SQUARE(game->row_player2/2, game->col_player2/2));
+	path_cache_move_pawn(&game->paths, &game->board, id_player, from);
+	record_move(game, MOVE_PAWN(id_player, game->board.pawn[id_player - 1]));
+}
+
+
+/* *******   FOR TOKENS. JUMP TO "FOR WALLS" BELOW   ****** */
 /**
  * @brief Color possible moves of the player, given its position in terms of row and column.
  *
+ * @details The moves are computed by the generator of the engine (no drawing
+ * inside), then drawn here. The flags possible_* and f2f_* are derived from
+ * the destinations: one step, two steps if the tokens are face to face.
+ *
+ * @param game  The match.
  * @param curr_row  The current row (0 to 6) where the player is.
  * @param curr_col  The current column (0 to 6) where the player is.
  * @param color			The color with which to highlight the possible moves.
  *
  * @return Nothing
  */
-void possible_moves(int curr_row, int curr_col, int color) {
-	/* CHECK FOR OUT OF BOARD, WALLS AND POSITION FREE (NO TOKEN) */
-	/* --- DOWN --- */
-	if (curr_row + 1 < BOARD_DIMENSION) {		/* if in board */
-		if(board[(curr_row+1)*2][curr_col*2] == 0) {	/* if free (no opponent). Board 13x13 */
-			if(board[(curr_row+1)*2-1][curr_col*2] == 0) {	/* and no wall */
-				draw_square(curr_row + 1, curr_col, color);
-				draw_square_edge(curr_row + 1, curr_col);
-			} else	/* no opponent, but wall */
-					possible_down = 0;
-		} else {	/* there is the opponent */
-			if (curr_row + 2 < BOARD_DIMENSION && 	/* IF NO OUT THE BOARD */
-						board[(curr_row+1)*2-1][curr_col*2] == 0 &&		/* NO WALL BETWEEN THE TWO PLAYER */
-						board[(curr_row+1)*2+1][curr_col*2] == 0) {		/* NO WALL BEHIND THE OPPONENT */
-							draw_square(curr_row + 2, curr_col, color);
-							draw_square_edge(curr_row + 2, curr_col);
-							f2f_down = 1;
-			} else
-					possible_down = 0;
-		}
-	} else	/* out of board */
-			possible_down = 0;
-	/* --- LEFT --- */
-	if (curr_col - 1 >= 0) {
-		if(board[curr_row*2][(curr_col-1)*2] == 0) {
-			if(board[curr_row*2][(curr_col-1)*2+1] == 0) {	
-				draw_square(curr_row, curr_col - 1, color);
-				draw_square_edge(curr_row, curr_col - 1);
-			} else
-					possible_left = 0;
-		} else {
-			if (curr_col - 2 >= 0 && 
-					board[curr_row*2][(curr_col-1)*2+1] == 0 &&
-					board[curr_row*2][(curr_col-1)*2-1] == 0) {
-						draw_square(curr_row, curr_col - 2, color);
-						draw_square_edge(curr_row, curr_col - 2);
-						f2f_left = 1;
-			} else
-					possible_left = 0;
-		}
-	} else
-			possible_left = 0;
-	/* --- RIGHT --- */
-	if (curr_col + 1 < BOARD_DIMENSION) {
-		if(board[curr_row*2][(curr_col+1)*2] == 0) {
-			if(board[curr_row*2][(curr_col+1)*2-1] == 0) {
-				draw_square(curr_row, curr_col + 1, color);
-				draw_square_edge(curr_row, curr_col + 1);
-			} else
-					possible_right = 0;
-		} else {
-			if (curr_col + 2 < BOARD_DIMENSION && 
-					board[curr_row*2][(curr_col+1)*2-1] == 0 &&
-					board[curr_row*2][(curr_col+1)*2+1] == 0) {
-						draw_square(curr_row, curr_col + 2, color);
-						draw_square_edge(curr_row, curr_col + 2);
-						f2f_right = 1;
-			} else
-					possible_right = 0;
-		}
-	} else
-			possible_right = 0;
-	/* UP */
-	if (curr_row - 1 >= 0) {
-		if(board[(curr_row-1)*2][curr_col*2] == 0) {
-			if(board[(curr_row-1)*2+1][curr_col*2] == 0) {
-				draw_square(curr_row - 1, curr_col, color);
-				draw_square_edge(curr_row - 1, curr_col);
-			} else
-					possible_up = 0;
-		} else {
-			if (curr_row - 2 >= 0 && 
-					board[(curr_row-1)*2-1][curr_col*2] == 0 &&
-					board[(curr_row-1)*2+1][curr_col*2] == 0) {
-						draw_square(curr_row - 2, curr_col, color);
-						draw_square_edge(curr_row - 2, curr_col);
-						f2f_up = 1;
-			} else
-					possible_up = 0;
-		}
-	} else
-			possible_up = 0;
-	
+void possible_moves(QuoridorGame *game, int curr_row, int curr_col, int color) {
+	MoveList list;
+	int i, dir, dest, sq = SQUARE(curr_row, curr_col);
+	int found[4] = {0, 0, 0, 0};	/* 0 NOT POSSIBLE, 1 ONE STEP, 2 FACE TO FACE (DOWN, LEFT, RIGHT, UP) */
+	PROBE_BEGIN(PROBE_POSSIBLE_MOVES);
+	FRAME_BEGIN();
+
+	/* #1 LEGAL MOVES OF THE TOKEN IN (curr_row, curr_col): OUT OF BOARD, WALLS AND OPPONENT */
+	board_gen_pawn_moves(&game->board, game->board.pawn[0] == sq ? 1 : 2, &list);
+	/* #2 HIGHLIGHT THE DESTINATIONS AND FIND THEIR DIRECTIONS */
+	for(i = 0; i < list.count; i++) {
+		dest = MOVE_SQUARE(list.move[i]);
+		draw_square(ROW_OF(dest), COL_OF(dest), color);
+		draw_square_edge(ROW_OF(dest), COL_OF(dest));
+		for(dir = 0; dir < 4; dir++)
+			if(dest == sq + step_offset[dir])
+				found[dir] = 1;
+			else if(dest == sq + 2*step_offset[dir])	/* TOKENS FACE TO FACE */
+				found[dir] = 2;
+	}
+	/* #3 UPDATE FLAGS (ALL OF THEM: A FLAG LEFT FROM A PREVIOUS TURN WOULD MAKE A STEP JUMP) */
+	game->possible_down = found[DIR_DOWN] != 0;
+	game->f2f_down = found[DIR_DOWN] == 2;
+	game->possible_left = found[DIR_LEFT] != 0;
+	game->f2f_left = found[DIR_LEFT] == 2;
+	game->possible_right = found[DIR_RIGHT] != 0;
+	game->f2f_right = found[DIR_RIGHT] == 2;
+	game->possible_up = found[DIR_UP] != 0;
+	game->f2f_up = found[DIR_UP] == 2;
+	FRAME_END();
+	PROBE_END(PROBE_POSSIBLE_MOVES);
 }
 
 /**
  * @brief Start a Quoridor match.
  *
- * @param No params
+ * @param game  The match.
  *
  * @return Nothing
  */
-void start_game(void) {
+void start_game(QuoridorGame *game) {
+	FRAME_BEGIN();
 	/* #1 THE MATCH STARTS, IN GAME MODE */
-	start_match = 1;
-	wall_mode = 0;
+	game->start_match = 1;
+	game->wall_mode = 0;
 	/* #2 PLAYER 1 IS THE FIRST (HIGHLIGHT ITS INFO RECTANGLE P1 Wall) */
-	mossa = 0;
-	start_turn1 = 1;
-	LCD_DrawLine(10, 255, 80, 255, Lavanda);
-	LCD_DrawLine(80, 255, 80, 300, Lavanda);
-	LCD_DrawLine(80, 300, 10, 300, Lavanda);
-	LCD_DrawLine(10, 300, 10, 255, Lavanda);
+	game->start_turn1 = 1;
+	game->start_turn2 = 0;
+	/* #2.1 NOTHING LEFT FROM THE PREVIOUS MATCH (END OF TURN, WALL PREVIEW, JUMPS) */
+	game->end_turn1 = game->end_turn2 = 0;
+	game->is_overlapped = game->is_previous_overlapped = game->is_out = 0;
+	game->trap1 = game->trap2 = 0;
+	game->f2f_down = game->f2f_left = game->f2f_right = game->f2f_up = 0;
+	PANEL_LINE(10, 255, 80, 255, Lavanda);
+	PANEL_LINE(80, 255, 80, 300, Lavanda);
+	PANEL_LINE(80, 300, 10, 300, Lavanda);
+	PANEL_LINE(10, 300, 10, 255, Lavanda);
 	/* #3 INITIALIZE POSITIONS OF PLAYERS */
-	row_player1 = 0;
-	row_player2 = 12;
-	col_player1 = 6;
-	col_player2 = 6;
+	game->row_player1 = 0;
+	game->row_player2 = BOARD_DIM - 1;
+	game->col_player1 = BOARD_DIMENSION - 1;		/* MIDDLE COLUMN OF THE VIEW */
+	game->col_player2 = BOARD_DIMENSION - 1;
 	/* #4 INITIAL POSITION OF WALL (HORIZONTAL, IN THE CENTER OF THE BOARD) */
-	posx_wall = 2;
-	posy_wall = 2;
-	horizontal = 1;
-	vertical = 0;
-	/* #5 COLOR POSSIBLE MOVES FOR PLAYER 1 */
+	game->posx_wall = (BOARD_DIMENSION - 3) / 2;
+	game->posy_wall = (BOARD_DIMENSION - 3) / 2;
+	game->horizontal = 1;
+	game->vertical = 0;
+	/* #5 INITIAL POSITIONS OF PLAYERS IN THE BITBOARD */
+	board_set_pawn(&game->board, 1, SQUARE(game->row_player1/2, game->col_player1/2));	/* FIRST PLAYER */
+	board_set_pawn(&game->board, 2, SQUARE(game->row_player2/2, game->col_player2/2));	/* SECOND PLAYER */
+	path_cache_init(&game->paths, &game->board);
+	if(game->log)
+		log_begin_game(game->log);		/* A MATCH STILL OPEN IS RECORDED AS UNFINISHED */
+	/* #6 COLOR POSSIBLE MOVES FOR PLAYER 1 (THE GENERATOR NEEDS THE TOKENS IN THE BITBOARD) */
 	/* *** The curr_row and curr_col parameters of possible_moves take on values 
 			between 0 and 6, while row_player and col_player take on values between 0 
 			and 12. Ex. row_player2 equal to 12 corresponds to curr_row equal to 6 *** */
-	possible_moves(row_player1/2, col_player1/2, Lavanda);
-	/* #6 INITIAL POSITIONS OF PLAYERS IN MATRIX BOARD */
-	board[row_player1][col_player1] = 1;	/* FIRST PLAYER */
-	board[row_player2][col_player2] = 2;	/* SECOND PLAYER */
+	possible_moves(game, game->row_player1/2, game->col_player1/2, Lavanda);
+	FRAME_END();
+}
+
+/**
+ * @brief Start a match on a blank display, as the touch on the panel does:
+ * board, info panels, tokens and walls left of both players.
+ *
+ * @param game  The match.
+ *
+ * @return Nothing
+ */
+void new_match(QuoridorGame *game) {
+	/* #1 EMPTY BOARD AND INFO PANELS (THE RENDERER MODEL IS BLACK AGAIN TOO) */
+	LCD_Clear(Black);
+#ifdef RENDER_DIRTY
+	render_init();
+#endif
+	draw_board();
+	show_info_layout();
+	/* #2 THE MATCH (HIGHLIGHT OF THE MOVES OF PLAYER 1) */
+	initialize_board(game);
+	start_game(game);
+	/* #3 TOKENS AND WALLS LEFT */
+	draw_player(game->row_player1/2, game->col_player1/2, White);
+	draw_player(game->row_player2/2, game->col_player2/2, Red);
+	show_update_wall(1, game->board.walls[0]);
+	show_update_wall(2, game->board.walls[1]);
 }
 
 /**
  * @brief Move token down.
  *
+ * @param game  The match.
  * @param id_player  The id of the player you intend to move down in the board.
  *
  * @return Nothing
  */
-void move_down_token(int id_player) {
+void move_down_token(QuoridorGame *game, int id_player) {
+	FRAME_BEGIN();
 	/* PLAYER 1 (WHITE) */
 	if (id_player == 1) {	
 		/* #1 RECOLOR PLAYER'S POSSIBLE MOVES TO BLACK (BACKGROUND COLOR OF THE BOARD) */
-		possible_moves(row_player1/2, col_player1/2, Black);
+		possible_moves(game, game->row_player1/2, game->col_player1/2, Black);
 		
 		/* #2 MANAGE THE MOVEMENT OF THE TOKEN */
-		if(row_player1 < BOARD_DIM - 2) {
-			/* #2.1 FREE THE CORRESPONDING POSITION IN BOARD 13X13 */
-			board[row_player1][col_player1] = 0;	
+		if(game->row_player1 < BOARD_DIM - 2) {
+			/* #2.1 CLEAN THE PREVIOUS POSITION OF THE TOKEN (BLACK SQUARE AND CONTOURS) */
+			draw_square(game->row_player1/2, game->col_player1/2, Black);		
+			draw_square_edge(game->row_player1/2, game->col_player1/2);	
 			
-			/* #2.2 CLEAN THE PREVIOUS POSITION OF THE TOKEN (BLACK SQUARE AND CONTOURS) */
-			draw_square(row_player1/2, col_player1/2, Black);		
-			draw_square_edge(row_player1/2, col_player1/2);	
-			
-			/* #2.3 CHECK IF THE TWO PLAYERS ARE FACE TO FACE */
+			/* #2.2 CHECK IF THE TWO PLAYERS ARE FACE TO FACE */
 			/* ALREADY CHECK THE POSSIBILITY OF GOING OUTSIDE THE BOARD IN possible_moves */
-			if(!f2f_down)
-				row_player1 = row_player1 + 2;	
+			if(!game->f2f_down)
+				game->row_player1 = game->row_player1 + 2;	
 			else
-				row_player1 = row_player1 + 4;
+				game->row_player1 = game->row_player1 + 4;
 			
-			/* #2.4 NEW POSITION IN BOARD 13X13 */
-			board[row_player1][col_player1] = 1;
+			/* #2.3 NEW POSITION IN THE BITBOARD (THE PREVIOUS ONE IS FREED) */
+			update_token(game, 1);
 			
-			/* #2.5 DRAW PLAYER 1 IN THE NEW POSITION */
-			draw_player(row_player1/2, col_player1/2, White);
+			/* #2.4 DRAW PLAYER 1 IN THE NEW POSITION */
+			draw_player(game->row_player1/2, game->col_player1/2, White);
 			
-			/* #2.6 END TURN 1. USEFUL FOR RESET THE TIMER */
-			end_turn1 = 1;
-			f2f_down = 0;
+			/* #2.5 END TURN 1. USEFUL FOR RESET THE TIMER */
+			game->end_turn1 = 1;
+			game->f2f_down = 0;
 			}
 	} else {	/* PLAYER 2 (RED) */
-		possible_moves(row_player2/2, col_player2/2, Black);
-		if(row_player2 < BOARD_DIM - 2) {
-			board[row_player2][col_player2] = 0;	
-			
-			draw_square(row_player2/2, col_player2/2, Black);		
-			draw_square_edge(row_player2/2, col_player2/2);			
+		possible_moves(game, game->row_player2/2, game->col_player2/2, Black);
+		if(game->row_player2 < BOARD_DIM - 2) {
+			draw_square(game->row_player2/2, game->col_player2/2, Black);		
+			draw_square_edge(game->row_player2/2, game->col_player2/2);			
 			
-			if(!f2f_down)
-				row_player2 = row_player2 + 2;	
+			if(!game->f2f_down)
+				game->row_player2 = game->row_player2 + 2;	
 			else
-				row_player2 = row_player2 + 4;
+				game->row_player2 = game->row_player2 + 4;
 			
-			board[row_player2][col_player2] = 2; 	/* POSITION PLAYER 2 IN BOARD */
+			update_token(game, 2); 	/* POSITION PLAYER 2 IN BOARD */
 			
-			draw_player(row_player2/2, col_player2/2, Red);
-			end_turn2 = 1;
+			draw_player(game->row_player2/2, game->col_player2/2, Red);
+			game->end_turn2 = 1;
 		}
 	}
+	FRAME_END();
 }
 
 /**
  * @brief Move token left.
  *
+ * @param game  The match.
  * @param id_player  The id of the player you intend to move down in the board.
  *
  * @return Nothing
  */
-void move_left_token(int id_player) {
+void move_left_token(QuoridorGame *game, int id_player) {
+	FRAME_BEGIN();
 	/* SIMILAR ACTIONS OF move_down_token. CHECK THIS FUNCTION FOR MORE EXPLANATIONS */
 	if (id_player == 1) {
-		possible_moves(row_player1/2, col_player1/2, Black);
-		if(col_player1 >= 2) {
-			board[row_player1][col_player1] = 0;	
+		possible_moves(game, game->row_player1/2, game->col_player1/2, Black);
+		if(game->col_player1 >= 2) {
+			draw_square(game->row_player1/2, game->col_player1/2, Black);		
+			draw_square_edge(game->row_player1/2, game->col_player1/2);			
 			
-			draw_square(row_player1/2, col_player1/2, Black);		
-			draw_square_edge(row_player1/2, col_player1/2);			
-			
-			if(!f2f_left)
-				col_player1 = col_player1 - 2;	
+			if(!game->f2f_left)
+				game->col_player1 = game->col_player1 - 2;	
 			else
-				col_player1 = col_player1 - 4;
+				game->col_player1 = game->col_player1 - 4;
 			
-			board[row_player1][col_player1] = 1;
+			update_token(game, 1);
 			
-			draw_player(row_player1/2, col_player1/2, White);
-			end_turn1 = 1;
+			draw_player(game->row_player1/2, game->col_player1/2, White);
+			game->end_turn1 = 1;
 			}
 	} else {	
-		possible_moves(row_player2/2, col_player2/2, Black);
-		if(col_player2 >= 2) {
-			board[row_player2][col_player2] = 0;	
-			
-			draw_square(row_player2/2, col_player2/2, Black);		
-			draw_square_edge(row_player2/2, col_player2/2);			
+		possible_moves(game, game->row_player2/2, game->col_player2/2, Black);
+		if(game->col_player2 >= 2) {
+			draw_square(game->row_player2/2, game->col_player2/2, Black);		
+			draw_square_edge(game->row_player2/2, game->col_player2/2);			
 			
-			if(!f2f_left)
-				col_player2 = col_player2 - 2;	
+			if(!game->f2f_left)
+				game->col_player2 = game->col_player2 - 2;	
 			else
-				col_player2 = col_player2 - 4;
+				game->col_player2 = game->col_player2 - 4;
 			
-			board[row_player2][col_player2] = 2;
+			update_token(game, 2);
 			
-			draw_player(row_player2/2, col_player2/2, Red);
-			end_turn2 = 1;
+			draw_player(game->row_player2/2, game->col_player2/2, Red);
+			game->end_turn2 = 1;
 			}
 	}
+	FRAME_END();
 }
 
 /**
  * @brief Move token right.
  *
+ * @param game  The match.
  * @param id_player  The id of the player you intend to move down in the board.
  *
  * @return Nothing
  */
-void move_right_token(int id_player) {
+void move_right_token(QuoridorGame *game, int id_player) {
+	FRAME_BEGIN();
 	/* SIMILAR ACTIONS OF move_down_token. CHECK THIS FUNCTION FOR MORE EXPLANATIONS */
 	if (id_player == 1) {		
-		possible_moves(row_player1/2, col_player1/2, Black);
-		if(col_player1 < BOARD_DIM - 2) {
-			board[row_player1][col_player1] = 0;	
-			
-			draw_square(row_player1/2, col_player1/2, Black);		
-			draw_square_edge(row_player1/2, col_player1/2);			
+		possible_moves(game, game->row_player1/2, game->col_player1/2, Black);
+		if(game->col_player1 < BOARD_DIM - 2) {
+			draw_square(game->row_player1/2, game->col_player1/2, Black);		
+			draw_square_edge(game->row_player1/2, game->col_player1/2);			
 			
-			if(!f2f_right)
-				col_player1 = col_player1 + 2;	
+			if(!game->f2f_right)
+				game->col_player1 = game->col_player1 + 2;	
 			else
-				col_player1 = col_player1 + 4;
+				game->col_player1 = game->col_player1 + 4;
 			
-			board[row_player1][col_player1] = 1;
+			update_token(game, 1);
 			
-			draw_player(row_player1/2, col_player1/2, White);
-			end_turn1 = 1;
+			draw_player(game->row_player1/2, game->col_player1/2, White);
+			game->end_turn1 = 1;
 			}
 	} else {	
-		possible_moves(row_player2/2, col_player2/2, Black);
-		if(col_player2 < BOARD_DIM - 2) {
-			board[row_player2][col_player2] = 0;	
+		possible_moves(game, game->row_player2/2, game->col_player2/2, Black);
+		if(game->col_player2 < BOARD_DIM - 2) {
+			draw_square(game->row_player2/2, game->col_player2/2, Black);		
+			draw_square_edge(game->row_player2/2, game->col_player2/2);			
 			
-			draw_square(row_player2/2, col_player2/2, Black);		
-			draw_square_edge(row_player2/2, col_player2/2);			
-			
-			if(!f2f_right)
-				col_player2 = col_player2 + 2;	
+			if(!game->f2f_right)
+				game->col_player2 = game->col_player2 + 2;	
 			else
-				col_player2 = col_player2 + 4;
+				game->col_player2 = game->col_player2 + 4;
 			
-			board[row_player2][col_player2] = 2; 
+			update_token(game, 2); 
 			
-			draw_player(row_player2/2, col_player2/2, Red);
-			end_turn2 = 1;
+			draw_player(game->row_player2/2, game->col_player2/2, Red);
+			game->end_turn2 = 1;
 			}
 	}
+	FRAME_END();
 }
 
 /**
  * @brief Move token up.
  *
+ * @param game  The match.
  * @param id_player  The id of the player you intend to move down in the board.
  *
  * @return Nothing
  */
-void move_up_token(int id_player) {
+void move_up_token(QuoridorGame *game, int id_player) {
+	FRAME_BEGIN();
 	/* SIMILAR ACTIONS OF move_down_token. CHECK THIS FUNCTION FOR MORE EXPLANATIONS */
 	if (id_player == 1) {		
-		possible_moves(row_player1/2, col_player1/2, Black);
-		if(row_player1 >= 2) {
-			board[row_player1][col_player1] = 0;	
-			
-			draw_square(row_player1/2, col_player1/2, Black);		
-			draw_square_edge(row_player1/2, col_player1/2);			
+		possible_moves(game, game->row_player1/2, game->col_player1/2, Black);
+		if(game->row_player1 >= 2) {
+			draw_square(game->row_player1/2, game->col_player1/2, Black);		
+			draw_square_edge(game->row_player1/2, game->col_player1/2);			
 			
-			if(!f2f_up) 
-				row_player1 = row_player1 - 2;	
+			if(!game->f2f_up) 
+				game->row_player1 = game->row_player1 - 2;	
 			else
-				row_player1 = row_player1 - 4;
+				game->row_player1 = game->row_player1 - 4;
 			
-			board[row_player1][col_player1] = 1;	
+			update_token(game, 1);	
 			
-			draw_player(row_player1/2, col_player1/2, White);
-			end_turn1 = 1;
+			draw_player(game->row_player1/2, game->col_player1/2, White);
+			game->end_turn1 = 1;
 			}
 	} else {	
-		possible_moves(row_player2/2, col_player2/2, Black);
-		if(row_player2 >= 2) {
-			board[row_player2][col_player2] = 0;	
+		possible_moves(game, game->row_player2/2, game->col_player2/2, Black);
+		if(game->row_player2 >= 2) {
+			draw_square(game->row_player2/2, game->col_player2/2, Black);		
+			draw_square_edge(game->row_player2/2, game->col_player2/2);			
 			
-			draw_square(row_player2/2, col_player2/2, Black);		
-			draw_square_edge(row_player2/2, col_player2/2);			
-			
-			if(!f2f_up)
-				row_player2 = row_player2 - 2;	
+			if(!game->f2f_up)
+				game->row_player2 = game->row_player2 - 2;	
 			else
-				row_player2 = row_player2 - 4;
+				game->row_player2 = game->row_player2 - 4;
 			
-			board[row_player2][col_player2] = 2; 
+			update_token(game, 2); 
 			
-			draw_player(row_player2/2, col_player2/2, Red);
-			end_turn2 = 1;
+			draw_player(game->row_player2/2, game->col_player2/2, Red);
+			game->end_turn2 = 1;
 			}
 	}
+	FRAME_END();
+}
+
+/* *******   FOR WALLS. JUMP TO "FOR TOKENS" ABOVE   ****** */
+/**
+ * @brief Slot (see Engine/Engine.h) of a wall, given its position on the display.
+ *
+ * @details For an horizontal wall posx goes from -1 to 4 and posy from 0 to 5,
+ * for a vertical one posx goes from 0 to 5 and posy from -1 to 4. In both cases
+ * the center of the wall is in the space between squares (posy*2+1, posx*2+3)
+ * or (posy*2+3, posx*2+1) of the matrix 13x13.
+ *
+ * @param game  The match.
+ * @param posx  The position in x (col) of the wall.
+ * @param posy  The position in y (row) of the wall.
+ *
+ * @return The slot of the wall, with the current orientation.
+ */
+static int wall_slot(const QuoridorGame *game, int posx, int posy) {
+	if(game->horizontal)
+		return SLOT(posy, posx + 1);
+	return SLOT(posy + 1, posx);
 }
 
-int overlap_pos[3][2];	/* MATRIX FOR COORDINATES OVERLAPPED */
-int opponent_wall[3];		/* ARRAY FOR DISTINGUISHING PLAYER 1 OR PLAYER 2 WALLS */
-/* *******   FOR WALLS. JUMP TO 241 FOR TOKENS   ****** */
 /**
  * @brief Check if a wall is overlapped with other walls.
  *
@@ -589,50 +668,58 @@ int opponent_wall[3];		/* ARRAY FOR DISTINGUISHING PLAYER 1 OR PLAYER 2 WALLS */
  * and which is now overlapped belongs to player 1 or player 2. This it is useful for 
  * rebuilding walls (function 'color_spaces13x13').
  *
+ * @param game  The match.
  * @param desidered_posx  The position in x (col) where you desire to place the wall.
  * @param desidered_posy  The position in y (row) where you desire to place the wall.
  *
  * @return 1 if it is overlapped. 0 otherwise
  */
-int is_overlapped_wall(int desidered_posx, int desidered_posy) {
+int is_overlapped_wall(QuoridorGame *game, int desidered_posx, int desidered_posy) {
 	int i, j, pos = 0, overlap = 0;
+	PROBE_BEGIN(PROBE_IS_OVERLAPPED_WALL);
 	/* #1 RESET ARRAY 'opponent_wall' AND MATRIX 'overlap_pos' */
 	for(i = 0; i < 3; i++)
-		opponent_wall[i] = 0;
+		game->opponent_wall[i] = 0;
 	for(i = 0; i < 3; i++)
 		for(j = 0; j < 2; j++)
-			overlap_pos[i][j] = 0;
-	/* #2 CHECK OVERLAP FOR HORIZONTAL WALLS */
-	if(horizontal) {
+			game->overlap_pos[i][j] = 0;
+	/* #2 FREE SLOT (NO WALL WITH THE SAME ORIENTATION OR CROSSING), NO OVERLAP: ONE BIT OF THE BOARD */
+	if(board_free_slots(&game->board, game->horizontal) >> wall_slot(game, desidered_posx, desidered_posy) & 1) {
+		PROBE_END(PROBE_IS_OVERLAPPED_WALL);
+		return 0;
+	}
+	/* #3 STORE THE OVERLAPPED CELLS FOR HORIZONTAL WALLS */
+	if(game->horizontal) {
 		/* EACH WALL OCCUPIES 3 CELLS IN MATRIX BOARD - 2 SQUARES AND 1 SPACE */
 		for(i = 0; i < 3; i++)
-			/* #2.1 IF SOME THIS 3 CELLS ARE NOT FREE */
-			if(board[desidered_posy*2+1][desidered_posx*2+2+i] != 0) {
-				/* #2.2 STORE IN THE ARRAY THE TYPE OF WALL (3 FOR PLAYER1, 4 FOR PLAYER2) */
-				if(board[desidered_posy*2+1][desidered_posx*2+2+i] == 3) 
-					opponent_wall[pos] = 3;
+			/* #3.1 IF SOME THIS 3 CELLS ARE NOT FREE */
+			if(board_cell(&game->board, desidered_posy*2+1, desidered_posx*2+2+i) != 0) {
+				/* #3.2 STORE IN THE ARRAY THE TYPE OF WALL (3 FOR PLAYER1, 4 FOR PLAYER2) */
+				if(board_cell(&game->board, desidered_posy*2+1, desidered_posx*2+2+i) == 3) 
+					game->opponent_wall[pos] = 3;
 				else
-					opponent_wall[pos] = 4;
-				/* #2.3 STORE IN THE MATRIX THE COORDINATES OF CELLS OVERLAPPED */
-				overlap_pos[pos][0] = desidered_posy*2+1;
-				overlap_pos[pos][1] = desidered_posx*2+2+i;
-				/* #2.4 UPDATE INDEX pos AND SET THE VARIABILE overlap TO 1 */
+					game->opponent_wall[pos] = 4;
+				/* #3.3 STORE IN THE MATRIX THE COORDINATES OF CELLS OVERLAPPED */
+				game->overlap_pos[pos][0] = desidered_posy*2+1;
+				game->overlap_pos[pos][1] = desidered_posx*2+2+i;
+				/* #3.4 UPDATE INDEX pos AND SET THE VARIABILE overlap TO 1 */
 				pos++;
 				overlap = 1;
 			}
 	} else {	/* VERTICAL WALLS */
 		for(i = 0; i < 3; i++)
-			if(board[desidered_posy*2+2+i][desidered_posx*2+1] != 0) {
-				if(board[desidered_posy*2+2+i][desidered_posx*2+1] == 3) 
-					opponent_wall[pos] = 3;
+			if(board_cell(&game->board, desidered_posy*2+2+i, desidered_posx*2+1) != 0) {
+				if(board_cell(&game->board, desidered_posy*2+2+i, desidered_posx*2+1) == 3) 
+					game->opponent_wall[pos] = 3;
 				else
-					opponent_wall[pos] = 4;
-				overlap_pos[pos][0] = desidered_posy*2+2+i;
-				overlap_pos[pos][1] = desidered_posx*2+1;
+					game->opponent_wall[pos] = 4;
+				game->overlap_pos[pos][0] = desidered_posy*2+2+i;
+				game->overlap_pos[pos][1] = desidered_posx*2+1;
 				pos++;
 				overlap = 1;
 			}
 	}
+	PROBE_END(PROBE_IS_OVERLAPPED_WALL);
 	return overlap;
 }
 
@@ -646,139 +733,152 @@ int is_overlapped_wall(int desidered_posx, int desidered_posy) {
  * @return Nothing
  */
 void color_spaces13x13(int i, int j, int color) {
+#ifdef RENDER_DIRTY
+	render_space(i, j, color);
+#else
 	int line;
-	/* EVEN COLUMN */
-	if(j % 2 == 0) {
-		for(line = 0; line <= 3; line++)
-			LCD_DrawLine(7 + 33*j/2, 6 + 28*(i/2+1) + 5*i/2 + line, 7 + 33*j/2 + 28, 6 + 28*(i/2+1) + 5*i/2 + line, color);
-	} else {	/* ODD COLUMN */
-		if(i % 2 == 0)	/* EVEN ROW */
-			for(line = 0; line <= 28; line++)
-				LCD_DrawLine(6 + 28*(j/2+1) + 5*j/2, 7 + 33*i/2 + line, 6 + 28*(j/2+1)+ 5*j/2 + 3, 7 + 33*i/2 + line, color); 
-		else	/* ODD ROW */
-			for(line = 0; line <= 3; line++)
-				LCD_DrawLine(6 + 28*(j/2+1) + 5*j/2, 6 + 28*(i/2+1) + 5*i/2 + line, 6 + 28*(j/2+1) + 5*j/2 + 3, 6 + 28*(i/2+1) + 5*i/2 + line, color);
-	}
+	int x = cell_start_px[j], y = cell_start_px[i];
+	int w = cell_size_px[j], h = cell_size_px[i];
+
+	/* ALONG THE LONGER SIDE: 4 LINES FOR EVERY SPACE */
+	if(w < h)	/* ODD COLUMN, EVEN ROW */
+		for(line = 0; line < w; line++)
+			LCD_DrawLine(x + line, y, x + line, y + h - 1, color);
+	else
+		for(line = 0; line < h; line++)
+			LCD_DrawLine(x, y + line, x + w - 1, y + line, color);
+#endif
+}
+
+/* *******   FLOOD FILL FOR NOT TRAPPING TOKENS   ****** */
+
+/** 
+ * @brief Tests if there are walls beetween two cells of the board.
+ *
+ * @param game  The match.
+ * @param current_row  The current row of the token (from 0 to 6).
+ * @param current_col  The current col of the token (from 0 to 6).
+ * @param new_row  The new row of the token that moves vertically.
+ * @param new_col  The new col of the token that moves horizontally.
+ *
+ * @return  1 if no wall between, so the road is free, 0 otherwise.
+ */
+int no_wall_between(const QuoridorGame *game, int current_row, int current_col, int new_row, int new_col) {
+	int dir;
+	/* #1 IF THE TOKEN MOVES HORIZONTALLY (SAME ROW - CHANGE COLUMN) */
+	if(current_row == new_row)
+		dir = current_col < new_col ? DIR_RIGHT : DIR_LEFT;
+	else	/* #2 IF THE TOKEN MOVES VERTICALLY (SAME COLUMN - CHANGE ROW) */
+		dir = current_row < new_row ? DIR_DOWN : DIR_UP;
+	/* #3 NO WALL BETWEEN IF THE STEP IS NOT CLOSED (VERTICAL WALL FOR LEFT/RIGHT, HORIZONTAL FOR UP/DOWN) */
+	return !(board_closed(&game->board, dir) >> SQUARE(current_row, current_col) & 1);
+}
+
+/** 
+ * @brief Tests whether adding a wall at a given position traps the player.
+ *
+ * @details A wall that does not cut the cached shortest path of the player
+ * cannot trap it. Otherwise the check is a bit-parallel flood fill: the board
+ * is never modified and no queue is used (see path_cache_traps).
+ *
+ * @param game  The match.
+ * @param id_player  The id of the player to be controlled is not trapped.
+ * @param posx  The posx index in which to try to place the new wall. 
+ * @param posy  The posy index in which to try to place the new wall.
+ *
+ * @return  1 if the player is trapped, the wall cannot be inserted, 0 otherwise.
+ */
+int is_trappola(QuoridorGame *game, int id_player, int posx, int posy) {
+	int trapped;
+	PROBE_BEGIN(PROBE_IS_TRAPPOLA);
+	trapped = path_cache_traps(&game->paths, &game->board, game->horizontal, wall_slot(game, posx, posy)) >> (id_player - 1) & 1;
+	PROBE_END(PROBE_IS_TRAPPOLA);
+	return trapped;
 }
 
-/* *******   BFS ALGORITHM FOR NOT TRAPPING TOKENS   ****** */
+/* *******   BFS ALGORITHM FOR NOT TRAPPING TOKENS (REFERENCE)   ****** */
+#ifdef QUORIDOR_SELFTEST
+
+static const int neighbors[4][2] = {{-1,0}, {1,0}, {0,-1}, {0,1}};		/* MATRIX FOR IDENTIFING NEIGHBORS */
+
+/* SCRATCH OF THE BFS. ON THE STACK OF is_trappola_bfs, SO NO STATE IS SHARED BETWEEN MATCHES */
+typedef struct {
+	int visited[BOARD_DIMENSION][BOARD_DIMENSION];
+	int queue[BOARD_DIMENSION * BOARD_DIMENSION * 4][2];
+} BfsScratch;
 
-int neighbors[4][2] = {{-1,0}, {1,0}, {0,-1}, {0,1}};		/* MATRIX FOR IDENTIFING NEIGHBORS */
-int visited[BOARD_DIMENSION][BOARD_DIMENSION];
-int queue[BOARD_DIMENSION * BOARD_DIMENSION * 4][2];
 /**
  * @brief Reset the two matrix useful for BFS (Breadth First Search) algorithm.
  * 
- * @param No params
+ * @param bfs  The scratch of the BFS.
  *
  * @return Nothing
  */
-void reset_matrix(void) {
+static void reset_matrix(BfsScratch *bfs) {
 	int i, j;
 	/* #1 RESET MATRIX OF VISITED NODES (7x7) */
 	for(i = 0; i < BOARD_DIMENSION; i++)
 		for(j = 0; j < BOARD_DIMENSION; j++)
-			visited[i][j] = 0;
+			bfs->visited[i][j] = 0;
 	/* #2 RESET QUEUE (7x7x4). IN GENERAL 4 NEIGHBORS */
 	for(i = 0; i < BOARD_DIMENSION*BOARD_DIMENSION*4; i++) {
-			queue[i][0] = 0;
-			queue[i][1] = 0;
+			bfs->queue[i][0] = 0;
+			bfs->queue[i][1] = 0;
 	}
 }
 
 /** 
- * @brief Tests if there are walls beetween two cells of the board.
+ * @brief Tests whether adding a wall at a given position traps the player (BFS).
  *
- * @param current_row  The current row of the token (from 0 to 6).
- * @param current_col  The current col of the token (from 0 to 6).
- * @param new_row  The new row of the token that moves vertically.
- * @param new_col  The new col of the token that moves horizontally.
- *
- * @return  1 if no wall between, so the road is free, 0 otherwise.
- */
-int no_wall_between(int current_row, int current_col, int new_row, int new_col) {
-	/* #1 IF THE TOKEN MOVES HORIZONTALLY (SAME ROW - CHANGE COLUMN) */
-	if(current_row == new_row) {
-		/* #1.1 MOVE RIGHT */
-		if(current_col < new_col) {
-			/* #1.2 IF THERE IS A WALL (VERTICAL WALL) BETWEEN */
-			if(board[current_row*2][current_col*2+1] != 0)
-				/* #1.3 RETURN */
-				return 0;
-		} else {	/* MOVE LEFT */
-			if(board[current_row*2][current_col*2-1] != 0)
-				return 0;
-		}		
-	}
-	/* #2 IF THE TOKEN MOVES VERTICALLY (SAME COLUMN - CHANGE ROW) */
-	if(current_col == new_col) {
-		/* #2.1 MOVE DOWN */
-		if(current_row < new_row) {
-			/* #2.2 IF THERE IS A WALL (HORIZONTAL WALL) BETWEEN */
-			if(board[current_row*2+1][current_col*2] != 0)
-				/* #2.3 RETURN */
-				return 0;
-		} else {	/* MOVE UP */
-			if(board[current_row*2-1][current_col*2] != 0)
-				return 0;
-		}		
-	}
-	/* #3 NO WALL BETWEEN */
-	return 1;
-}
-
-/** 
- * @brief Tests whether adding a wall at a given position traps the player.
+ * @details First implementation of is_trappola, with a queue over the 7x7
+ * squares. Kept only as a reference for check_trappola.
  *
+ * @param game  The match.
  * @param id_player  The id of the player to be controlled is not trapped.
  * @param posx  The posx index in which to try to place the new wall. 
  * @param posy  The posy index in which to try to place the new wall.
  *
  * @return  1 if the player is trapped, the wall cannot be inserted, 0 otherwise.
  */
-int is_trappola(int id_player, int posx, int posy) {
+int is_trappola_bfs(QuoridorGame *game, int id_player, int posx, int posy) {
 	int i, new_row, new_col, end, front = 0, rear = 0;
-	reset_matrix();		/* RESET MATRIX OF VISITED NODES AND MATRIX FOR QUEUE */
+	Board saved = game->board;	/* BOARD WITHOUT THE WALL TO BE TRIED */
+	BfsScratch bfs;
+	reset_matrix(&bfs);		/* RESET MATRIX OF VISITED NODES AND MATRIX FOR QUEUE */
 	
 	/* #1 INIZIALITATION FOR CHECKING TRAP OF PLAYER1 */
 	if(id_player == 1) {
 		/* #1.1 STORE IN QUEUE THE INITIAL POSITION OF PLAYER1 */
-		queue[rear][0] = row_player1/2;
-		queue[rear][1] = col_player1/2;
+		bfs.queue[rear][0] = game->row_player1/2;
+		bfs.queue[rear][1] = game->col_player1/2;
 		/* #1.2 SET THE INITIAL POSITION OF PLAYER1 AS A VISITED NODE */
-		visited[row_player1/2][col_player1/2] = 1;
+		bfs.visited[game->row_player1/2][game->col_player1/2] = 1;
 		/* #1.3 INSERT WALL IN THE SPECIFIED POSITION */
-		/* If, at the end, there is not a valid path for reaching the opposite part, 
-			 TRAP. Delete the wall you just inserted from the matrix. */
-		for(i = 0; i < 3; i++) 
-			if(horizontal)
-				board[posy*2+1][posx*2+2+i] = 3;
-			else
-				board[posy*2+2+i][posx*2+1] = 3;
+		/* At the end, with or without a valid path for reaching the opposite part, 
+			 the board is restored. The wall is really inserted only by position_wall. */
+		board_place_wall(&game->board, game->horizontal, wall_slot(game, posx, posy), 1);
 		/* #1.4 OPPOSITE PART OF THE BOARD FRO PLAYER1 */
-		end = 6;
+		end = BOARD_DIMENSION - 1;
 	} else {	/* INIZIALITATION FOR CHECKING TRAP OF PLAYER2 */
-		queue[rear][0] = row_player2/2;
-		queue[rear][1] = col_player2/2;
-		visited[row_player2/2][col_player2/2] = 1;
-		for(i = 0; i < 3; i++) 
-			if(horizontal)
-				board[posy*2+1][posx*2+2+i] = 4;
-			else
-				board[posy*2+2+i][posx*2+1] = 4;
+		bfs.queue[rear][0] = game->row_player2/2;
+		bfs.queue[rear][1] = game->col_player2/2;
+		bfs.visited[game->row_player2/2][game->col_player2/2] = 1;
+		board_place_wall(&game->board, game->horizontal, wall_slot(game, posx, posy), 2);
 		end = 0;
 	}
 	
 	/* #2 AS LONG AS THERE ARE NEW ELEMENTS IN THE QUEUE STILL TO EXPLORE */
 	while(front <= rear) {
 		/* #2.1 POP THE FIRST ELEMENT IN THE QUEUE NOT YET EXPLORED. THIS IS THE CURRENT POSITION OF THE PLAYER */
-		int current_row = queue[front][0];
-		int current_col = queue[front][1];
+		int current_row = bfs.queue[front][0];
+		int current_col = bfs.queue[front][1];
 		front++;
 		
 		/* #2.2 IF CURRENT ROW IS EQUAL TO 6 (FOR PLAYER1), THERE IS A VALID PATH */
-		if(current_row == end)
+		if(current_row == end) {
+			game->board = saved;
 			return 0;
+		}
 		
 		/* #2.3 ANALYZE NEIGHBOR OF THE CURRENT POSITION */
 		for(i = 0; i < 4; i++) {
@@ -788,250 +888,412 @@ int is_trappola(int id_player, int posx, int posy) {
 			
 			/* #2.4 IF THE NEW POSITION IS VALID (NO OUT OF THE BOARD), IT IS NOT YET EXPLORED AND NO WALL BETWEEN THAT AVOID MOVE... */
 			if(new_row >= 0 && new_row < BOARD_DIMENSION && new_col >= 0 && new_col < BOARD_DIMENSION &&
-					!visited[new_row][new_col] && no_wall_between(current_row, current_col, new_row, new_col)) {
+					!bfs.visited[new_row][new_col] && no_wall_between(game, current_row, current_col, new_row, new_col)) {
 					/* #2.5 PUSH IN THE QUEUE THE NEW POSITION */
-					queue[++rear][0] = new_row;
-					queue[rear][1] = new_col;
+					bfs.queue[++rear][0] = new_row;
+					bfs.queue[rear][1] = new_col;
 					/* #2.6 SET AS VISITED */
-					visited[new_row][new_col] = 1;
+					bfs.visited[new_row][new_col] = 1;
 			}
 		}
 	} 
 	
 	/* #3. IF WE HAVE ANALYZED THE ENTIRE QUEUE (NO NEW LOCATIONS TO VISIT) AND HAVE NOT EXIT (no return 0), THE PLAYER IS TRAPPED */
 	/* #3.1 DELETE WALL INSERTED IN 1.3 */
-	for(i = 0; i < 3; i++) 
-		if(horizontal)
-			board[posy*2+1][posx*2+2+i] = 0;
-		else
-			board[posy*2+2+i][posx*2+1] = 0;
+	game->board = saved;
 		/* #3.2 PLAYER TRAPPED :( */
 	return 1;
 }
 
+/**
+ * @brief Cross-check of is_trappola against the reference BFS on random wall sets.
+ *
+ * @details For each set, tokens are placed on random squares and up to 16 random
+ * walls are inserted (overlapped ones are discarded, trapping ones too). Then
+ * every free slot, in both orientations, is tried for both players with the two
+ * implementations (is_trappola goes through the cache of the shortest paths).
+ * The board of the match is lost: call it before the match starts.
+ *
+ * @param game  The match.
+ * @param sets  The number of random wall sets.
+ * @param seed  The seed of the random generator.
+ *
+ * @return The number of mismatches (0 if the two implementations agree).
+ */
+int check_trappola(QuoridorGame *game, int sets, uint32_t seed) {
+	int set, k, x, y, id_player, mismatches = 0;
+	for(set = 0; set < sets; set++) {
+		/* #1 RANDOM TOKENS ON DIFFERENT SQUARES */
+		board_init(&game->board);
+		seed = seed * 1103515245u + 12345u;
+		game->row_player1 = (seed >> 16) % BOARD_DIMENSION * 2;
+		game->col_player1 = (seed >> 24) % BOARD_DIMENSION * 2;
+		do {
+			seed = seed * 1103515245u + 12345u;
+			game->row_player2 = (seed >> 16) % BOARD_DIMENSION * 2;
+			game->col_player2 = (seed >> 24) % BOARD_DIMENSION * 2;
+		} while(game->row_player2 == game->row_player1 && game->col_player2 == game->col_player1);
+		board_set_pawn(&game->board, 1, SQUARE(game->row_player1/2, game->col_player1/2));
+		board_set_pawn(&game->board, 2, SQUARE(game->row_player2/2, game->col_player2/2));
+		/* #2 RANDOM WALLS, NEITHER OVERLAPPED NOR TRAPPING */
+		for(k = 0; k < 16; k++) {
+			seed = seed * 1103515245u + 12345u;
+			game->horizontal = (seed >> 12) & 1;
+			game->posx_wall = (seed >> 16) % WALL_DIMENSION - game->horizontal;
+			game->posy_wall = (seed >> 24) % WALL_DIMENSION - !game->horizontal;
+			if(!is_overlapped_wall(game, game->posx_wall, game->posy_wall) && !board_trapped(&game->board, game->horizontal, wall_slot(game, game->posx_wall, game->posy_wall)))
+				board_place_wall(&game->board, game->horizontal, wall_slot(game, game->posx_wall, game->posy_wall), 1 + (k & 1));
+		}
+		path_cache_init(&game->paths, &game->board);
+		/* #3 EVERY FREE SLOT, BOTH ORIENTATIONS, BOTH PLAYERS */
+		for(game->horizontal = 0; game->horizontal <= 1; game->horizontal++)
+			for(y = -!game->horizontal; y < WALL_DIMENSION - !game->horizontal; y++)
+				for(x = -game->horizontal; x < WALL_DIMENSION - game->horizontal; x++)
+					if(!is_overlapped_wall(game, x, y))
+						for(id_player = 1; id_player <= 2; id_player++)
+							if(is_trappola(game, id_player, x, y) != is_trappola_bfs(game, id_player, x, y))
+								mismatches++;
+	}
+	board_init(&game->board);
+	game->horizontal = 1;
+	return mismatches;
+}
+#endif
+
 /**
  * @brief Re-draw walls (a wall overlapped them and they need to be rebuilt).
  *
- * @param overlap_pos[][]  Matrix 3x2 that contains coordinates of cells overlapped.
+ * @param game  The match. Its matrix 3x2 'overlap_pos' contains coordinates of cells
+ * overlapped (see is_overlapped_wall).
  * 
  * @return Nothing
  */
-void redraw_walls(int overlap_pos[][2]) {
+void redraw_walls(const QuoridorGame *game) {
 	int i;
 	for(i = 0; i < 3; i++)
-		if(overlap_pos[i][0] != 0 && overlap_pos[i][1] != 0) {
-			if(opponent_wall[i] == 3)
-				color_spaces13x13(overlap_pos[i][0], overlap_pos[i][1], Beige);
+		if(game->overlap_pos[i][0] != 0 && game->overlap_pos[i][1] != 0) {
+			if(game->opponent_wall[i] == 3)
+				color_spaces13x13(game->overlap_pos[i][0], game->overlap_pos[i][1], Beige);
 			else
-				color_spaces13x13(overlap_pos[i][0], overlap_pos[i][1], Red);
+				color_spaces13x13(game->overlap_pos[i][0], game->overlap_pos[i][1], Red);
 	}
 }
 
 /**
  * @brief Move down wall if it is possible (no out the board).
  *
+ * @param game  The match.
  * @param id_player  The id of the player that positions the wall. Useful in future?
  * 
  * @return Nothing
  */
-void move_down_wall(int id_player) {
+void move_down_wall(QuoridorGame *game, int id_player) {
 	int overlap = 1;
+	FRAME_BEGIN();
 	/* #1 CHECK IF THE WALL IN THE NEW DESIDERED POSITION WOULD BE OVERLAPPED */
 	/* CHECK IT IF THE NEW POSITION IS CONTAINED IN THE BOARD. IF IT GOES OUT... */
 	/* THE WALL IS HORIZONTAL OR VERTICAL (NEVER BOTH AT THE SAME TIME) */
-	if((horizontal && posy_wall+1 < BOARD_DIMENSION-1) || (vertical && posy_wall+1 < BOARD_DIMENSION-2)) {
+	if((game->horizontal && game->posy_wall+1 < BOARD_DIMENSION-1) || (game->vertical && game->posy_wall+1 < BOARD_DIMENSION-2)) {
 		/* #2 CHECK IF THE WALL IS OVERLAPPED IN THE PREVIOUS MOVEMENT */
-		if(is_previous_overlapped) {
-			draw_wall(posx_wall, posy_wall, Black);
+		if(game->is_previous_overlapped) {
+			draw_wall(game->posx_wall, game->posy_wall, game->horizontal, Black);
 			/* #2.1 RE-DRAW ALREADY POSITION WALLS */
-			redraw_walls(overlap_pos);
+			redraw_walls(game);
 		}
-		overlap = is_overlapped_wall(posx_wall, posy_wall+1);
-		if(!is_previous_overlapped)
-			draw_wall(posx_wall, posy_wall, Black);
-		posy_wall = posy_wall + 1;
+		overlap = is_overlapped_wall(game, game->posx_wall, game->posy_wall+1);
+		if(!game->is_previous_overlapped)
+			draw_wall(game->posx_wall, game->posy_wall, game->horizontal, Black);
+		game->posy_wall = game->posy_wall + 1;
 	
-		if(start_turn1)
-			draw_wall(posx_wall, posy_wall, Hazelnut);
+		if(game->start_turn1)
+			draw_wall(game->posx_wall, game->posy_wall, game->horizontal, Hazelnut);
 		else
-			draw_wall(posx_wall, posy_wall, Violet);
+			draw_wall(game->posx_wall, game->posy_wall, game->horizontal, Violet);
 			
 		if(overlap) {
-			is_overlapped = 1;
-			is_previous_overlapped = 1;
+			game->is_overlapped = 1;
+			game->is_previous_overlapped = 1;
 		} else {
-			is_overlapped = 0;
-			is_previous_overlapped = 0;
+			game->is_overlapped = 0;
+			game->is_previous_overlapped = 0;
 		}
 	} else
-			is_out = 1;
+			game->is_out = 1;
+	FRAME_END();
 }
 
 /**
  * @brief Move left wall if it is possible (no out the board, no overlap)
  *
+ * @param game  The match.
  * @param id_player  The id of the player that positions the wall. Useful in future?
  * 
  * @return Nothing
  */
-void move_left_wall(int id_player) {
+void move_left_wall(QuoridorGame *game, int id_player) {
 	int overlap = 1;
+	FRAME_BEGIN();
 	/* SIMILAR ACTIONS OF move_down_wall. CHECK THIS FUNCTION FOR MORE EXPLANATIONS */
-	if((horizontal && posx_wall-1 >= -1) || (vertical && posx_wall-1 >= 0)) {
-		if(is_previous_overlapped) {
-			draw_wall(posx_wall, posy_wall, Black);
-			redraw_walls(overlap_pos);
+	if((game->horizontal && game->posx_wall-1 >= -1) || (game->vertical && game->posx_wall-1 >= 0)) {
+		if(game->is_previous_overlapped) {
+			draw_wall(game->posx_wall, game->posy_wall, game->horizontal, Black);
+			redraw_walls(game);
 		}
-		overlap = is_overlapped_wall(posx_wall-1, posy_wall);
-		if(!is_previous_overlapped)
-			draw_wall(posx_wall, posy_wall, Black);
-		posx_wall = posx_wall - 1;
-		if(start_turn1)
-			draw_wall(posx_wall, posy_wall, Hazelnut);
+		overlap = is_overlapped_wall(game, game->posx_wall-1, game->posy_wall);
+		if(!game->is_previous_overlapped)
+			draw_wall(game->posx_wall, game->posy_wall, game->horizontal, Black);
+		game->posx_wall = game->posx_wall - 1;
+		if(game->start_turn1)
+			draw_wall(game->posx_wall, game->posy_wall, game->horizontal, Hazelnut);
 		else
-			draw_wall(posx_wall, posy_wall, Violet);
+			draw_wall(game->posx_wall, game->posy_wall, game->horizontal, Violet);
 		
 		if(overlap) {
-				is_overlapped = 1;
-				is_previous_overlapped = 1;
+				game->is_overlapped = 1;
+				game->is_previous_overlapped = 1;
 		} else {
-			is_overlapped = 0;
-			is_previous_overlapped = 0;
+			game->is_overlapped = 0;
+			game->is_previous_overlapped = 0;
 		}
 	} else
-			is_out = 1;
+			game->is_out = 1;
+	FRAME_END();
 }
 
 /**
  * @brief Move right wall if it is possible (no out the board, no overlap)
  *
+ * @param game  The match.
  * @param id_player  The id of the player that positions the wall. Useful in future?
  * 
  * @return Nothing
  */
-void move_right_wall(int id_player) {
+void move_right_wall(QuoridorGame *game, int id_player) {
 	int overlap = 1;
+	FRAME_BEGIN();
 	/* SIMILAR ACTIONS OF move_down_wall. CHECK THIS FUNCTION FOR MORE EXPLANATIONS */
-	if((horizontal && posx_wall+1 < BOARD_DIMENSION-2) || (vertical && posx_wall+1 < BOARD_DIMENSION-1)) {
-		if(is_previous_overlapped) {
-			draw_wall(posx_wall, posy_wall, Black);
-			redraw_walls(overlap_pos);
+	if((game->horizontal && game->posx_wall+1 < BOARD_DIMENSION-2) || (game->vertical && game->posx_wall+1 < BOARD_DIMENSION-1)) {
+		if(game->is_previous_overlapped) {
+			draw_wall(game->posx_wall, game->posy_wall, game->horizontal, Black);
+			redraw_walls(game);
 		}
-		overlap = is_overlapped_wall(posx_wall+1, posy_wall);
-		if(!is_previous_overlapped)
-			draw_wall(posx_wall, posy_wall, Black);
-		posx_wall = posx_wall + 1;
-		if(start_turn1)
-			draw_wall(posx_wall, posy_wall, Hazelnut);
+		overlap = is_overlapped_wall(game, game->posx_wall+1, game->posy_wall);
+		if(!game->is_previous_overlapped)
+			draw_wall(game->posx_wall, game->posy_wall, game->horizontal, Black);
+		game->posx_wall = game->posx_wall + 1;
+		if(game->start_turn1)
+			draw_wall(game->posx_wall, game->posy_wall, game->horizontal, Hazelnut);
 		else
-			draw_wall(posx_wall, posy_wall, Violet);
+			draw_wall(game->posx_wall, game->posy_wall, game->horizontal, Violet);
 		
 		if(overlap) {
-				is_overlapped = 1;
-				is_previous_overlapped = 1;
+				game->is_overlapped = 1;
+				game->is_previous_overlapped = 1;
 		} else {
-			is_overlapped = 0;
-			is_previous_overlapped = 0;
+			game->is_overlapped = 0;
+			game->is_previous_overlapped = 0;
 		}
 	} else
-			is_out = 1;
+			game->is_out = 1;
+	FRAME_END();
 }
 
 /**
  * @brief Move up wall if it is possible (no out the board, no overlap)
  *
+ * @param game  The match.
  * @param id_player  The id of the player that positions the wall. Useful in future?
  * 
  * @return Nothing
  */
-void move_up_wall(int id_player) {
+void move_up_wall(QuoridorGame *game, int id_player) {
 	int overlap = 1;
+	FRAME_BEGIN();
 	/* SIMILAR ACTIONS OF move_down_wall. CHECK THIS FUNCTION FOR MORE EXPLANATIONS */
-	if((horizontal && posy_wall-1 >= 0) || (vertical && posy_wall-1 >= -1)) {
-		if(is_previous_overlapped) {
-			draw_wall(posx_wall, posy_wall, Black);
-			redraw_walls(overlap_pos);
+	if((game->horizontal && game->posy_wall-1 >= 0) || (game->vertical && game->posy_wall-1 >= -1)) {
+		if(game->is_previous_overlapped) {
+			draw_wall(game->posx_wall, game->posy_wall, game->horizontal, Black);
+			redraw_walls(game);
 		}
-		overlap = is_overlapped_wall(posx_wall, posy_wall-1);
-		if(!is_previous_overlapped)
-			draw_wall(posx_wall, posy_wall, Black);
-		posy_wall = posy_wall - 1;
-		if(start_turn1)
-			draw_wall(posx_wall, posy_wall, Hazelnut);
+		overlap = is_overlapped_wall(game, game->posx_wall, game->posy_wall-1);
+		if(!game->is_previous_overlapped)
+			draw_wall(game->posx_wall, game->posy_wall, game->horizontal, Black);
+		game->posy_wall = game->posy_wall - 1;
+		if(game->start_turn1)
+			draw_wall(game->posx_wall, game->posy_wall, game->horizontal, Hazelnut);
 		else
-			draw_wall(posx_wall, posy_wall, Violet);
+			draw_wall(game->posx_wall, game->posy_wall, game->horizontal, Violet);
 		
 		if(overlap) {
-			is_overlapped = 1;
-			is_previous_overlapped = 1;
+			game->is_overlapped = 1;
+			game->is_previous_overlapped = 1;
 		} else {
-			is_overlapped = 0;
-			is_previous_overlapped = 0;
+			game->is_overlapped = 0;
+			game->is_previous_overlapped = 0;
 		}
 	} else
-			is_out = 1;
+			game->is_out = 1;
+	FRAME_END();
 }
 
 /**
  * @brief Rotate if it is possible (no out the board, no overlap)
  *
+ * @param game  The match.
+ *
  * @return Nothing
  */
-void rotate_wall(void) {
+void rotate_wall(QuoridorGame *game) {
 	int overlap;
+	FRAME_BEGIN();
 	/* DELETE PREVIOUS WALL (BEFORE CHANGE FROM HORIZONTAL TO VERTICAL OR VICEVERSA */
-	draw_wall(posx_wall, posy_wall, Black);
+	draw_wall(game->posx_wall, game->posy_wall, game->horizontal, Black);
 	/* IF WALLS ARE PREVOIUS OVERLAPPED, REDRAW THEM */
-	if(is_previous_overlapped)
-		redraw_walls(overlap_pos);
+	if(game->is_previous_overlapped)
+		redraw_walls(game);
 	/* CHANGE WALL ORIENTATION AND NEW COORDINATES */
-	if(horizontal) {
-			horizontal = 0;
-			vertical = 1;
-			posx_wall = posx_wall + 1;
-			posy_wall = posy_wall - 1;
+	if(game->horizontal) {
+			game->horizontal = 0;
+			game->vertical = 1;
+			game->posx_wall = game->posx_wall + 1;
+			game->posy_wall = game->posy_wall - 1;
 	} else {
-			vertical = 0;
-			horizontal = 1;
-			posx_wall = posx_wall - 1;
-			posy_wall = posy_wall + 1;
+			game->vertical = 0;
+			game->horizontal = 1;
+			game->posx_wall = game->posx_wall - 1;
+			game->posy_wall = game->posy_wall + 1;
 	}
 	/* IF WALL IN THE NEW ORIENTATION, OVERLAP OTHERS WALLS */
-	overlap = is_overlapped_wall(posx_wall, posy_wall);
+	overlap = is_overlapped_wall(game, game->posx_wall, game->posy_wall);
 	if(overlap) {
-			is_overlapped = 1;
-			is_previous_overlapped = 1;
+			game->is_overlapped = 1;
+			game->is_previous_overlapped = 1;
 		} else {
-			is_overlapped = 0;
-			is_previous_overlapped = 0;
+			game->is_overlapped = 0;
+			game->is_previous_overlapped = 0;
 		}
 	/* DRAW WALL IN THE NEW POSITION (ROTATE OF 90 DEGREES) */
-	if(start_turn1)
-		draw_wall(posx_wall, posy_wall, Hazelnut);
+	if(game->start_turn1)
+		draw_wall(game->posx_wall, game->posy_wall, game->horizontal, Hazelnut);
 	else
-		draw_wall(posx_wall, posy_wall, Violet);
+		draw_wall(game->posx_wall, game->posy_wall, game->horizontal, Violet);
+	FRAME_END();
 }
 
-void position_wall(int id_player) {
-	int i;
-	trap1 = is_trappola(1, posx_wall, posy_wall);
-	trap2 = is_trappola(2, posx_wall, posy_wall);
-	if(start_turn1 && !trap1 && !trap2) {
-		draw_wall(posx_wall, posy_wall, Beige);
-		/* WALL1 (3,2) -> board[2*2+1][3*2+2+i], il muro occupa 3 celle della matrice 13x13 */
-		for(i = 0; i < 3; i++) 
-			if(horizontal)
-				board[posy_wall*2+1][posx_wall*2+2+i] = 3;
-			else
-				board[posy_wall*2+2+i][posx_wall*2+1] = 3;
-		end_turn1 = 1;
-	} else if(start_turn2 && !trap1 && !trap2){
-		draw_wall(posx_wall, posy_wall, Red);
-		for(i = 0; i < 3; i++)
-			if(horizontal)
-				board[posy_wall*2+1][posx_wall*2+2+i] = 4;
-			else
-				board[posy_wall*2+2+i][posx_wall*2+1] = 4;
-		end_turn2 = 1;
+void position_wall(QuoridorGame *game, int id_player) {
+	/* ONE CALL ANSWERS FOR BOTH PLAYERS (FLOOD FILL ONLY IF A CACHED PATH IS CUT) */
+	int slot = wall_slot(game, game->posx_wall, game->posy_wall), traps;
+	PROBE_BEGIN(PROBE_POSITION_WALL);
+	PROBE_BEGIN(PROBE_IS_TRAPPOLA);		/* THE TRAP CHECK OF is_trappola, FOR BOTH PLAYERS */
+	traps = path_cache_traps(&game->paths, &game->board, game->horizontal, slot);
+	PROBE_END(PROBE_IS_TRAPPOLA);
+	FRAME_BEGIN();
+	game->trap1 = traps & 1;
+	game->trap2 = traps >> 1 & 1;
+	if(game->start_turn1 && !game->trap1 && !game->trap2) {
+		draw_wall(game->posx_wall, game->posy_wall, game->horizontal, Beige);
+		/* WALL1 (3,2) -> SLOT (2,4), CENTER IN board_cell(2*2+1, 3*2+3) OF THE 13x13 VIEW */
+		board_place_wall(&game->board, game->horizontal, slot, 1);
+		path_cache_place_wall(&game->paths, &game->board, game->horizontal, slot);
+		record_move(game, MOVE_WALL(1, game->horizontal, slot));
+		game->end_turn1 = 1;
+	} else if(game->start_turn2 && !game->trap1 && !game->trap2){
+		draw_wall(game->posx_wall, game->posy_wall, game->horizontal, Red);
+		board_place_wall(&game->board, game->horizontal, slot, 2);
+		path_cache_place_wall(&game->paths, &game->board, game->horizontal, slot);
+		record_move(game, MOVE_WALL(2, game->horizontal, slot));
+		game->end_turn2 = 1;
 	}
-} 
+	FRAME_END();
+	PROBE_END(PROBE_POSITION_WALL);
+}
+
+/* ***************   COMPUTER PLAYER   *************** */
+/**
+ * @brief Play a move of the engine (see Engine/Engine.h) through the same
+ * functions used by the joystick: move_*_token for tokens, position_wall for walls.
+ *
+ * @details It must be the turn of the player of the move (start_turn1 or
+ * start_turn2 set), as for a move made with the joystick. The counter of the
+ * walls on the display is updated after a wall.
+ *
+ * @param game  The match.
+ * @param m  The move (a legal one).
+ *
+ * @return Nothing
+ */
+void play_move(QuoridorGame *game, Move m) {
+	int id_player = MOVE_PLAYER(m), sq = MOVE_SQUARE(m), from = game->board.pawn[id_player - 1], dir;
+
+	FRAME_BEGIN();
+	if(MOVE_IS_WALL(m)) {
+		/* #1 SLOT -> POSITION OF THE WALL (INVERSE OF wall_slot) */
+		game->horizontal = MOVE_HORIZONTAL(m);
+		game->vertical = !game->horizontal;
+		game->posx_wall = COL_OF(sq) - game->horizontal;
+		game->posy_wall = ROW_OF(sq) - game->vertical;
+		position_wall(game, id_player);
+		show_update_wall(id_player, game->board.walls[id_player - 1]);
+	} else {
+		/* #2 DIRECTION OF THE TOKEN (ONE STEP OR A JUMP FACE TO FACE) */
+		for(dir = 0; dir < 4; dir++)
+			if(sq == from + step_offset[dir] || sq == from + 2*step_offset[dir])
+				break;
+		if(dir == DIR_DOWN)
+			move_down_token(game, id_player);
+		else if(dir == DIR_LEFT)
+			move_left_token(game, id_player);
+		else if(dir == DIR_RIGHT)
+			move_right_token(game, id_player);
+		else if(dir == DIR_UP)
+			move_up_token(game, id_player);
+	}
+	FRAME_END();
+}
+
+/**
+ * @brief Let the computer play the turn of a player.
+ *
+ * @details The move is chosen by the alpha-beta search of the engine, within
+ * the limits set in 's' (depth, time budget and clock: on the board the budget
+ * must stay below the 20 seconds of the turn timer), then played with play_move.
+ * With 'game->ponder' set and a transposition table in 's', the pondering then
+ * starts on the position left to the opponent (see computer_ponder).
+ *
+ * @param game  The match.
+ * @param id_player  The player controlled by the computer.
+ * @param s  The search, with its limits. Its results describe the move chosen.
+ *
+ * @return The move played, MOVE_NONE if the player has no legal move.
+ */
+Move computer_move(QuoridorGame *game, int id_player, Search *s) {
+	Move m = search_best_move(s, &game->board, &game->paths, id_player);
+	if(m != MOVE_NONE)
+		play_move(game, m);
+	if(game->ponder && s->tt)
+		ponder_start(game->ponder, &game->board, &game->paths, 3 - id_player, s->tt, s->clock_ms);
+	return m;
+}
+
+/**
+ * @brief Think during the turn of the opponent, one slice at a time.
+ *
+ * @details To be called while the opponent of the computer chooses its move:
+ * on the board from the main loop, by input_drain when no input event is
+ * waiting (the slice bounds the delay of the next event), on the host from a
+ * thread. Each slice searches the position left
+ * by computer_move one depth deeper (ponder_slice), on the table of the
+ * computer. A move of the opponent, by move_*_token or position_wall, stops the
+ * pondering, and computer_move finds in the table the subtree of that move.
+ *
+ * @param game  The match.
+ * @param slice_ms  The time budget of the slice.
+ *
+ * @return The depth completed so far, -1 if there is nothing to ponder (no
+ * pondering started, opponent moved, match over).
+ */
+int computer_ponder(QuoridorGame *game, uint32_t slice_ms) {
+	if(!game->ponder || game->ponder->abort)
+		return -1;
+	return ponder_slice(game->ponder, slice_ms);
+}
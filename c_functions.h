@@ -0,0 +1,77 @@
+#ifndef __C_FUNCTIONS_H
+#define __C_FUNCTIONS_H
+
+#include <stdint.h>
+#include "Engine/Engine.h"
+
+/**
+ * @brief State of a Quoridor match.
+ *
+ * @details Everything that belongs to a match (board, tokens, turns, wall
+ * under placement) lives here, so that any number of matches can exist at the
+ * same time: every gaming function takes the match explicitly. The board
+ * firmware uses the default instance 'default_game'. The fields keep the names
+ * of the former globals: rows and columns of the players go from 0 to 12
+ * (matrix 13x13), positions of the wall from -1 to 5 (see draw_wall).
+ */
+typedef struct {
+	Board board;
+	PathCache paths;		/* SHORTEST PATHS OF THE TWO PLAYERS, KEPT IN SYNC WITH board */
+	int start_match, start_turn1, start_turn2, end_turn1, end_turn2;
+	int row_player1, row_player2, col_player1, col_player2;
+	int f2f_down, f2f_left, f2f_right, f2f_up;	/* TOKENS FACE TO FACE */
+	int posx_wall, posy_wall, horizontal, vertical, is_overlapped, is_previous_overlapped, is_out, trap1, trap2;
+	volatile int possible_down, possible_left, possible_right, possible_up;
+	int wall_mode;					/* THE JOYSTICK MOVES THE WALL PREVIEW (KEY1), NOT THE TOKEN */
+	int seconds;						/* TIME LEFT IN THE TURN */
+	int overlap_pos[3][2];	/* MATRIX FOR COORDINATES OVERLAPPED */
+	int opponent_wall[3];		/* ARRAY FOR DISTINGUISHING PLAYER 1 OR PLAYER 2 WALLS */
+	GameLog *log;						/* RECORD OF THE MOVES (NULL FOR NONE), KEPT ACROSS MATCHES */
+	Ponder *ponder;					/* SEARCH DURING THE TURN OF THE OPPONENT (NULL FOR NONE), STOPPED BY ANY MOVE */
+} QuoridorGame;
+
+extern QuoridorGame default_game;
+
+/* DRAWING FUNCTIONS */
+void clean_zone(int start_x, int start_y, int length);
+void draw_square_edge(int row, int col);
+void draw_board(void);
+void show_info_layout(void);
+void show_update_wall(int id_player, int walls);
+void show_timer(int seconds);
+void draw_player(int row, int col, int color);
+void draw_wall(int posx, int posy, int horizontal, int color);
+void draw_square(int row, int col, int color);
+void color_spaces13x13(int i, int j, int color);
+
+/* GAMING FUNCTIONS */
+void initialize_board(QuoridorGame *game);
+void possible_moves(QuoridorGame *game, int curr_row, int curr_col, int color);
+void start_game(QuoridorGame *game);
+void new_match(QuoridorGame *game);
+void move_down_token(QuoridorGame *game, int id_player);
+void move_left_token(QuoridorGame *game, int id_player);
+void move_right_token(QuoridorGame *game, int id_player);
+void move_up_token(QuoridorGame *game, int id_player);
+int is_overlapped_wall(QuoridorGame *game, int desidered_posx, int desidered_posy);
+int no_wall_between(const QuoridorGame *game, int current_row, int current_col, int new_row, int new_col);
+int is_trappola(QuoridorGame *game, int id_player, int posx, int posy);
+void redraw_walls(const QuoridorGame *game);
+void move_down_wall(QuoridorGame *game, int id_player);
+void move_left_wall(QuoridorGame *game, int id_player);
+void move_right_wall(QuoridorGame *game, int id_player);
+void move_up_wall(QuoridorGame *game, int id_player);
+void rotate_wall(QuoridorGame *game);
+void position_wall(QuoridorGame *game, int id_player);
+
+/* COMPUTER PLAYER */
+void play_move(QuoridorGame *game, Move m);
+Move computer_move(QuoridorGame *game, int id_player, Search *s);
+int computer_ponder(QuoridorGame *game, uint32_t slice_ms);
+
+#ifdef QUORIDOR_SELFTEST
+int is_trappola_bfs(QuoridorGame *game, int id_player, int posx, int posy);
+int check_trappola(QuoridorGame *game, int sets, uint32_t seed);
+#endif
+
+#endif
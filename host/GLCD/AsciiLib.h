@@ -0,0 +1,8 @@
+#ifndef __ASCIILIB_H
+#define __ASCIILIB_H
+
+/* HOST STUB OF THE LANDTIGER FONT 8x16 (see glcd_stub.c) */
+
+void GetASCIICode(unsigned char *pBuffer, unsigned char ASCII);
+
+#endif
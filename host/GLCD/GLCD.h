@@ -0,0 +1,56 @@
+#ifndef __GLCD_H
+#define __GLCD_H
+
+/* HOST STUB OF THE LANDTIGER GLCD DRIVER. SAME API OF THE BOARD, NOTHING IS
+	 DRAWN: CALLS AND PIXELS ARE ONLY COUNTED IN 'glcd_stats' (see glcd_stub.c). */
+
+#include <stdint.h>
+
+/* LCD COLORS (RGB565) */
+#define White          0xFFFF
+#define Black          0x0000
+#define Grey           0xF7DE
+#define Blue           0x001F
+#define Blue2          0x051F
+#define Red            0xF800
+#define Magenta        0xF81F
+#define Green          0x07E0
+#define Cyan           0x7FFF
+#define Yellow         0xFFE0
+#define Lavanda        0xE73F
+#define Hazelnut       0x8BA3
+#define Violet         0x895C
+#define Beige          0xF7BB
+
+#define RGB565CONVERT(red, green, blue) (int) (((red >> 3) << 11) | ((green >> 2) << 5) | (blue >> 3))
+
+#define MAX_X  240
+#define MAX_Y  320
+
+/* WINDOWED BLOCK WRITE (LCD_SetWindow + LCD_WriteGRAM), USED BY THE RENDERER
+	 OF Render/. THE BOARD DRIVER OFFERS IT WHEN IT DEFINES GLCD_HAS_WINDOW. */
+#ifndef GLCD_NO_WINDOW
+#define GLCD_HAS_WINDOW
+#endif
+
+typedef struct {
+	uint32_t lines;		/* LCD_DrawLine CALLS */
+	uint32_t points;	/* LCD_SetPoint CALLS */
+	uint32_t texts;		/* CHARACTERS WRITTEN BY GUI_Text AND PutChar */
+	uint32_t blocks;	/* LCD_SetWindow CALLS (ONE BLOCK WRITE EACH) */
+	uint32_t pixels;	/* PIXELS WRITTEN BY ALL THE CALLS */
+} GlcdStats;
+
+extern GlcdStats glcd_stats;
+
+void LCD_Initialization(void);
+void LCD_Clear(uint16_t Color);
+uint16_t LCD_GetPoint(uint16_t Xpos, uint16_t Ypos);
+void LCD_SetPoint(uint16_t Xpos, uint16_t Ypos, uint16_t point);
+void LCD_DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color);
+void LCD_SetWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+void LCD_WriteGRAM(const uint16_t *pixels, uint32_t count);
+void PutChar(uint16_t Xpos, uint16_t Ypos, uint8_t ASCI, uint16_t charColor, uint16_t bkColor);
+void GUI_Text(uint16_t Xpos, uint16_t Ypos, uint8_t *str, uint16_t Color, uint16_t bkColor);
+
+#endif
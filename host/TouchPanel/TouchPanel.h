@@ -0,0 +1,16 @@
+#ifndef __TOUCHPANEL_H
+#define __TOUCHPANEL_H
+
+/* HOST STUB OF THE LANDTIGER TOUCH PANEL DRIVER. NO TOUCH IS EVER READ. */
+
+#include <stdint.h>
+
+typedef struct {
+	uint16_t x;
+	uint16_t y;
+} Coordinate;
+
+void TP_Init(void);
+Coordinate *Read_Ads7846(void);
+
+#endif
@@ -0,0 +1,89 @@
+#include <stdlib.h>
+#include "GLCD/GLCD.h"
+#include "TouchPanel/TouchPanel.h"
+
+/* ***************   HOST BACKEND OF GLCD AND TOUCH PANEL   *************** */
+/* Nothing is drawn. Every call is counted, together with the pixels it would
+	 write on the 240x320 display, so that the drawing cost can be measured. */
+
+GlcdStats glcd_stats;
+
+void LCD_Initialization(void) {
+}
+
+void LCD_Clear(uint16_t Color) {
+	(void) Color;
+	glcd_stats.pixels += MAX_X * MAX_Y;
+}
+
+uint16_t LCD_GetPoint(uint16_t Xpos, uint16_t Ypos) {
+	(void) Xpos;
+	(void) Ypos;
+	return Black;
+}
+
+void LCD_SetPoint(uint16_t Xpos, uint16_t Ypos, uint16_t point) {
+	(void) Xpos;
+	(void) Ypos;
+	(void) point;
+	glcd_stats.points++;
+	glcd_stats.pixels++;
+}
+
+void LCD_DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color) {
+	int dx = abs((int) x1 - (int) x0), dy = abs((int) y1 - (int) y0);
+	(void) color;
+	glcd_stats.lines++;
+	glcd_stats.pixels += (dx > dy ? dx : dy) + 1;		/* ONE PIXEL PER STEP OF THE LONGEST AXIS */
+}
+
+void LCD_SetWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+	(void) x0;
+	(void) y0;
+	(void) x1;
+	(void) y1;
+	glcd_stats.blocks++;
+}
+
+void LCD_WriteGRAM(const uint16_t *pixels, uint32_t count) {
+	(void) pixels;
+	glcd_stats.pixels += count;
+}
+
+/**
+ * @brief Glyph of a character, font 8x16. The font of the board is not here: a
+ * pattern derived from the code (empty for the space) stands for it.
+ */
+void GetASCIICode(unsigned char *pBuffer, unsigned char ASCII) {
+	int row;
+	for(row = 0; row < 16; row++)
+		pBuffer[row] = ASCII == ' ' || row < 2 || row > 13 ? 0 : (unsigned char) ((ASCII * (row + 3) * 0x3B) & 0x7E);
+}
+
+void PutChar(uint16_t Xpos, uint16_t Ypos, uint8_t ASCI, uint16_t charColor, uint16_t bkColor) {
+	(void) Xpos;
+	(void) Ypos;
+	(void) ASCI;
+	(void) charColor;
+	(void) bkColor;
+	glcd_stats.texts++;
+	glcd_stats.pixels += 8 * 16;	/* FONT 8x16 */
+}
+
+void GUI_Text(uint16_t Xpos, uint16_t Ypos, uint8_t *str, uint16_t Color, uint16_t bkColor) {
+	(void) Xpos;
+	(void) Ypos;
+	(void) Color;
+	(void) bkColor;
+	while(*str++) {
+		glcd_stats.texts++;
+		glcd_stats.pixels += 8 * 16;
+	}
+}
+
+void TP_Init(void) {
+}
+
+Coordinate *Read_Ads7846(void) {
+	return 0;
+}
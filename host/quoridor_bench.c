@@ -0,0 +1,769 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "GLCD/GLCD.h"
+#include "c_functions.h"
+
+/* ***************   HOST BENCHMARK OF THE GAME LOGIC   *************** */
+/* Usage: quoridor_bench [scale] [tt_mb]. Every benchmark runs 'scale' times its
+	 default number of iterations. The transposition table of the search takes
+	 'tt_mb' MB (64 if not given). Positions and games come from a fixed seed, so two
+	 runs of the same build measure exactly the same work. */
+
+#define POSITIONS 64		/* MID-GAME POSITIONS USED BY THE MICRO BENCHMARKS */
+#define MAX_PLIES 1000	/* A RANDOM GAME LONGER THAN THIS IS STOPPED */
+#define DRAW_OPS 100000	/* TOKENS DRAWN BY THE SPRITE BENCHMARK */
+#define COMPUTER_GAMES 10
+#define LOG_GAMES 20000	/* RANDOM GAMES OF THE LOG BENCHMARK */
+#define LOG_CHUNK 4096	/* BUFFER OF THE LOG WRITER, FLUSHED TO MEMORY */
+#define MCTS_NODES (1 << 20)	/* ARENA OF THE MONTE CARLO TREE SEARCH */
+
+typedef struct {
+	Board board;
+	PathCache paths;
+	int id_player;	/* PLAYER TO MOVE */
+} Sample;
+
+static Sample samples[POSITIONS];
+static uint32_t seed = 2463534242u;
+static volatile uint32_t sink;	/* KEEPS RESULTS ALIVE */
+static TransTable tt;
+static uint8_t *stream;	/* GAME LOG WRITTEN BY stream_sink */
+static uint32_t stream_length, stream_capacity;
+
+/**
+ * @brief Pseudo-random number (xorshift32).
+ */
+static uint32_t next_random(void) {
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+
+/**
+ * @brief Monotonic time in seconds.
+ */
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Millisecond clock of the search.
+ */
+static uint32_t clock_ms(void) {
+	return (uint32_t) (now() * 1000);
+}
+
+static void report(const char *name, long ops, double seconds) {
+	printf("%-30s %12ld ops %10.1f ns/op %14.0f ops/s\n", name, ops, seconds * 1e9 / ops, ops / seconds);
+}
+
+/**
+ * @brief Play uniformly random legal moves until a player wins. A player
+ * without legal moves (token boxed in, no walls left) passes.
+ *
+ * @return The number of plies played.
+ */
+static int random_game(Board *b, PathCache *pc, int id_player, int max_plies) {
+	MoveList list;
+	int ply;
+	for(ply = 0; ply < max_plies && !board_winner(b); ply++) {
+		if(board_gen_moves(b, pc, id_player, &list))
+			board_play(b, pc, list.move[next_random() % list.count]);
+		id_player = 3 - id_player;
+	}
+	return ply;
+}
+
+/**
+ * @brief Mid-game positions: 4 to 19 random plies from the start.
+ */
+static void build_samples(void) {
+	int i, plies;
+	for(i = 0; i < POSITIONS; i++) {
+		board_init(&samples[i].board);
+		board_start(&samples[i].board);
+		path_cache_init(&samples[i].paths, &samples[i].board);
+		plies = random_game(&samples[i].board, &samples[i].paths, 1, 4 + next_random() % 16);
+		samples[i].id_player = 1 + plies % 2;
+		if(board_winner(&samples[i].board))
+			i--;	/* GAME ALREADY OVER, TRY AGAIN */
+	}
+}
+
+/**
+ * @brief Load a sample in a match, as if it had been played on the board.
+ */
+static void load_sample(QuoridorGame *game, const Sample *s) {
+	initialize_board(game);
+	game->board = s->board;
+	game->paths = s->paths;
+	game->row_player1 = ROW_OF(s->board.pawn[0]) * 2;
+	game->col_player1 = COL_OF(s->board.pawn[0]) * 2;
+	game->row_player2 = ROW_OF(s->board.pawn[1]) * 2;
+	game->col_player2 = COL_OF(s->board.pawn[1]) * 2;
+}
+
+static void bench_movegen(int scale) {
+	MoveList list;
+	long ops = 0;
+	int r, i;
+	double start = now();
+	for(r = 0; r < 2000 * scale; r++)
+		for(i = 0; i < POSITIONS; i++, ops++)
+			sink += board_gen_moves(&samples[i].board, &samples[i].paths, samples[i].id_player, &list);
+	report("board_gen_moves", ops, now() - start);
+	start = now();
+	ops = 0;
+	for(r = 0; r < 20000 * scale; r++)
+		for(i = 0; i < POSITIONS; i++, ops++)
+			sink += board_gen_pawn_moves(&samples[i].board, samples[i].id_player, &list);
+	report("board_gen_pawn_moves", ops, now() - start);
+}
+
+/**
+ * @brief is_trappola or is_overlapped_wall on every position of the wall
+ * cursor (both orientations) of every sample.
+ */
+static void bench_walls(int scale, int trap) {
+	static QuoridorGame game;
+	long ops = 0;
+	int r, i, x, y;
+	uint32_t hits = 0, misses = 0;
+	double elapsed = 0, start;
+
+	for(i = 0; i < POSITIONS; i++) {
+		load_sample(&game, &samples[i]);
+		start = now();
+		for(r = 0; r < 100 * scale; r++)
+			for(game.horizontal = 0; game.horizontal <= 1; game.horizontal++)
+				for(y = -!game.horizontal; y < WALL_DIMENSION - !game.horizontal; y++)
+					for(x = -game.horizontal; x < WALL_DIMENSION - game.horizontal; x++, ops++)
+						if(trap)
+							sink += is_trappola(&game, 1 + (x & 1), x, y);
+						else
+							sink += is_overlapped_wall(&game, x, y);
+		elapsed += now() - start;
+		hits += game.paths.hits - samples[i].paths.hits;
+		misses += game.paths.misses - samples[i].paths.misses;
+	}
+	report(trap ? "is_trappola" : "is_overlapped_wall", ops, elapsed);
+	if(trap)
+		printf("%-30s %12u hits %8u misses (%u%%)\n", "  path cache", hits, misses,
+			(unsigned) (hits + misses ? (uint64_t) hits * 100 / (hits + misses) : 100));
+}
+
+static void bench_games(int scale) {
+	Board b;
+	PathCache pc;
+	long games, plies = 0, wins[3] = {0, 0, 0};
+	double start = now();
+	for(games = 0; games < 2000 * scale; games++) {
+		board_init(&b);
+		board_start(&b);
+		path_cache_init(&pc, &b);
+		plies += random_game(&b, &pc, 1, MAX_PLIES);
+		wins[board_winner(&b)]++;
+	}
+	report("random games", games, now() - start);
+	printf("%-30s %12.1f plies/game, wins %ld/%ld, unfinished %ld\n", "", (double) plies / games, wins[1], wins[2], wins[0]);
+}
+
+/**
+ * @brief Zobrist keys: the incremental key must match the one computed from
+ * scratch after every move of some random games.
+ *
+ * @return The number of mismatches.
+ */
+static int check_keys(int games) {
+	Board b;
+	PathCache pc;
+	MoveList list;
+	int g, ply, id_player, mismatches = 0;
+	for(g = 0; g < games; g++) {
+		board_init(&b);
+		board_start(&b);
+		path_cache_init(&pc, &b);
+		for(ply = 0, id_player = 1; ply < MAX_PLIES && !board_winner(&b); ply++, id_player = 3 - id_player) {
+			if(board_gen_moves(&b, &pc, id_player, &list))
+				board_play(&b, &pc, list.move[next_random() % list.count]);
+			mismatches += b.key != board_compute_key(&b);
+		}
+	}
+	return mismatches;
+}
+
+/**
+ * @brief Free wall slots: the masks kept by the board must match the conflicts
+ * of every slot (board_wall_conflicts) after every move of some random games
+ * and after a wall is taken back.
+ *
+ * @return The number of mismatches.
+ */
+static int check_free_slots(int games) {
+	Board b;
+	PathCache pc;
+	MoveList list;
+	Undo undo;
+	int g, ply, id_player, horizontal, slot, mismatches = 0;
+	for(g = 0; g < games; g++) {
+		board_init(&b);
+		board_start(&b);
+		path_cache_init(&pc, &b);
+		for(ply = 0, id_player = 1; ply < MAX_PLIES && !board_winner(&b); ply++, id_player = 3 - id_player) {
+			if(board_gen_moves(&b, &pc, id_player, &list)) {
+				make_move(&b, &pc, list.move[list.count - 1], &undo);		/* A WALL, IF ANY */
+				unmake_move(&b, &pc, &undo);
+				board_play(&b, &pc, list.move[(g + ply * 7) % list.count]);	/* NOT next_random: SAME SAMPLES */
+			}
+			for(horizontal = 0; horizontal < 2; horizontal++)
+				for(slot = 0; slot < BOARD_SQUARES; slot++)
+					if(SLOTS_MASK >> slot & 1)
+						mismatches += (int) (board_free_slots(&b, horizontal) >> slot & 1) == !!board_wall_conflicts(&b, horizontal, slot);
+		}
+	}
+	return mismatches;
+}
+
+/**
+ * @brief Tests whether a cache holds the same paths of a reference one, and
+ * the distances computed from scratch for the board (the incremental updates
+ * of path_cache_place_wall).
+ */
+static int same_cache(const PathCache *a, const PathCache *ref, const Board *b) {
+	PathCache fresh, updated = *a;
+	int p;
+	path_cache_init(&fresh, b);
+	for(p = 0; p < 2; p++)
+		if(a->path_s[p] != ref->path_s[p] || a->path_e[p] != ref->path_e[p] || a->length[p] != ref->length[p]
+				|| memcmp(path_cache_dist(&updated, b, p + 1), fresh.dist[p], BOARD_SQUARES))
+			return 0;
+	return 1;
+}
+
+/**
+ * @brief make_move + unmake_move of every legal move of the samples must give
+ * back the same board and the same cache, and make_move must give the same
+ * position of board_play on copies.
+ *
+ * @return The number of mismatches.
+ */
+static int check_make_unmake(void) {
+	Board b, copy;
+	PathCache pc, copy_pc;
+	MoveList list;
+	Undo undo;
+	int i, k, mismatches = 0;
+	for(i = 0; i < POSITIONS; i++) {
+		b = samples[i].board;
+		pc = samples[i].paths;
+		board_gen_moves(&b, &pc, samples[i].id_player, &list);
+		for(k = 0; k < list.count; k++) {
+			copy = b;
+			copy_pc = pc;
+			board_play(&copy, &copy_pc, list.move[k]);
+			make_move(&b, &pc, list.move[k], &undo);
+			mismatches += memcmp(&b, &copy, sizeof(Board)) != 0 || !same_cache(&pc, &copy_pc, &b);
+			unmake_move(&b, &pc, &undo);
+			mismatches += memcmp(&b, &samples[i].board, sizeof(Board)) != 0 || !same_cache(&pc, &samples[i].paths, &b);
+		}
+	}
+	return mismatches;
+}
+
+/**
+ * @brief Try and take back every legal move of the samples: make_move +
+ * unmake_move against board_play on copies of board and cache.
+ */
+static void bench_make_unmake(int scale) {
+	Board b;
+	PathCache pc;
+	MoveList list[POSITIONS];
+	Undo undo;
+	long ops = 0;
+	int r, i, k;
+	double start;
+
+	for(i = 0; i < POSITIONS; i++)
+		board_gen_moves(&samples[i].board, &samples[i].paths, samples[i].id_player, &list[i]);
+	start = now();
+	for(r = 0; r < 500 * scale; r++)
+		for(i = 0; i < POSITIONS; i++) {
+			b = samples[i].board;
+			pc = samples[i].paths;
+			for(k = 0; k < list[i].count; k++, ops++) {
+				make_move(&b, &pc, list[i].move[k], &undo);
+				sink += pc.length[0];
+				unmake_move(&b, &pc, &undo);
+			}
+		}
+	report("make_move + unmake_move", ops, now() - start);
+	ops = 0;
+	start = now();
+	for(r = 0; r < 500 * scale; r++)
+		for(i = 0; i < POSITIONS; i++)
+			for(k = 0; k < list[i].count; k++, ops++) {
+				b = samples[i].board;
+				pc = samples[i].paths;
+				board_play(&b, &pc, list[i].move[k]);
+				sink += pc.length[0];
+			}
+	report("copy + board_play", ops, now() - start);
+}
+
+/**
+ * @brief Alpha-beta search at fixed depths on the samples (time and nodes per
+ * move), without and with the transposition table.
+ */
+static void bench_search_depths(Search *s, int scale, const char *label) {
+	long nodes;
+	int depth, i;
+	double start, elapsed;
+	char name[32];
+
+	for(depth = 1; depth <= 2 + scale; depth++) {
+		s->max_depth = depth;
+		nodes = 0;
+		start = now();
+		for(i = 0; i < POSITIONS; i += 8) {
+			sink += search_best_move(s, &samples[i].board, &samples[i].paths, samples[i].id_player);
+			nodes += s->nodes;
+		}
+		elapsed = now() - start;
+		sprintf(name, "search depth %d%s", depth, label);
+		printf("%-30s %12ld nodes %8.1f ms/move %12.0f nodes/s\n", name, nodes, elapsed * 1000 / (POSITIONS / 8), nodes / elapsed);
+	}
+}
+
+/**
+ * @brief Search at fixed depths, then with a time budget from the start position.
+ */
+static void bench_search(int scale) {
+	Search s;
+	Board b;
+	PathCache pc;
+	double start;
+
+	search_init(&s);
+	bench_search_depths(&s, scale, "");
+	s.tt = &tt;
+	tt_clear(&tt);
+	bench_search_depths(&s, scale, " (tt)");
+	printf("%-30s %12u probes %8u hits %8u stores\n", "  transposition table", tt.probes, tt.hits, tt.stores);
+	board_init(&b);
+	board_start(&b);
+	path_cache_init(&pc, &b);
+	s.max_depth = SEARCH_MAX_DEPTH;
+	s.budget_ms = 500;
+	s.clock_ms = clock_ms;
+	start = now();
+	search_best_move(&s, &b, &pc, 1);
+	printf("%-30s %12u nodes %8.1f ms      depth %d, score %d\n", "search 500 ms (start)", s.nodes, (now() - start) * 1000, s.depth, s.score);
+}
+
+/**
+ * @brief Monte Carlo tree search: rollouts alone from the samples, then whole
+ * searches from the start (playouts per second, nodes of the arena).
+ */
+static void bench_mcts(int scale) {
+	static MctsNode arena[MCTS_NODES];
+	long rollouts = 2000L * POSITIONS * scale, i;
+	uint32_t plies = 0, rollout_seed = 1;
+	Mcts m;
+	Board b;
+	PathCache pc;
+	double start, elapsed;
+
+	start = now();
+	for(i = 0; i < rollouts; i++) {
+		b = samples[i % POSITIONS].board;
+		pc = samples[i % POSITIONS].paths;
+		sink += mcts_rollout(&b, &pc, samples[i % POSITIONS].id_player, &rollout_seed, &plies);
+	}
+	elapsed = now() - start;
+	printf("%-30s %12ld rollouts %8.1f us/rollout %10.0f rollouts/s %5.1f plies\n", "mcts_rollout", rollouts,
+		elapsed * 1e6 / rollouts, rollouts / elapsed, (double) plies / rollouts);
+	board_init(&b);
+	board_start(&b);
+	path_cache_init(&pc, &b);
+	mcts_init(&m, arena, MCTS_NODES);
+	m.playouts = 20000 * scale;
+	start = now();
+	sink += mcts_best_move(&m, &b, &pc, 1);
+	elapsed = now() - start;
+	printf("%-30s %12u playouts %8.1f ms/move %10.0f playouts/s %8u nodes, %d%%\n", "mcts (start)", m.done,
+		elapsed * 1000, m.done / elapsed, m.used, m.win_rate);
+}
+
+/**
+ * @brief Sink of a game log: the chunks are appended to 'stream' (a file would
+ * do the same).
+ */
+static void stream_sink(const uint8_t *data, uint32_t length) {
+	if(stream_length + length > stream_capacity) {
+		stream_capacity = (stream_capacity + length) * 2;
+		stream = realloc(stream, stream_capacity);
+		if(!stream)
+			exit(1);
+	}
+	memcpy(stream + stream_length, data, length);
+	stream_length += length;
+}
+
+/**
+ * @brief Random game (as random_game) written to a log.
+ *
+ * @param moves  If not NULL, receives the moves played.
+ * @param count  If not NULL, receives the number of moves played.
+ *
+ * @return The winner (0 if stopped after MAX_PLIES).
+ */
+static int log_random_game(GameLog *log, Move *moves, int *count) {
+	Board b;
+	PathCache pc;
+	MoveList list;
+	int ply, n = 0, id_player = 1;
+	Move m;
+
+	board_init(&b);
+	board_start(&b);
+	path_cache_init(&pc, &b);
+	log_begin_game(log);
+	for(ply = 0; ply < MAX_PLIES && !board_winner(&b); ply++) {
+		if(board_gen_moves(&b, &pc, id_player, &list)) {
+			m = list.move[next_random() % list.count];
+			board_play(&b, &pc, m);
+			log_move(log, m);
+			if(moves)
+				moves[n] = m;
+			n++;
+		}
+		id_player = 3 - id_player;
+	}
+	log_end_game(log, board_winner(&b));
+	if(count)
+		*count = n;
+	return board_winner(&b);
+}
+
+/**
+ * @brief Game logs: random games written through a small buffer flushed to
+ * memory, read back in small chunks, must give the same moves and winners. A
+ * log without sink must keep only complete games.
+ *
+ * @return The number of mismatches.
+ */
+static int check_log(int games) {
+	static uint8_t small[61], bounded[1000];
+	GameLog log;
+	LogReader r;
+	Move m;
+	Move *expected = malloc((size_t) games * MAX_PLIES * sizeof(Move));
+	int *count = malloc(games * sizeof(int)), *winner = malloc(games * sizeof(int));
+	int g, k, n = 0, status, mismatches = 0;
+	uint32_t pos;
+
+	if(!expected || !count || !winner)
+		return 1;
+	/* #1 WRITE, KEEPING THE MOVES */
+	stream_length = 0;
+	log_init(&log, small, sizeof(small), stream_sink);
+	for(g = 0; g < games; g++) {
+		winner[g] = log_random_game(&log, expected + (size_t) g * MAX_PLIES, &count[g]);
+	}
+	log_flush(&log);
+	/* #2 READ IN CHUNKS OF 7 BYTES */
+	g = k = 0;
+	log_reader_init(&r, stream, 0);
+	for(pos = 0; pos < stream_length; pos += 7) {
+		log_reader_feed(&r, stream + pos, stream_length - pos < 7 ? stream_length - pos : 7);
+		while((status = log_read(&r, &m)) != LOG_READ_MORE) {
+			if(status == LOG_READ_BAD || g >= games)
+				return mismatches + 1;
+			if(status == LOG_READ_MOVE) {
+				mismatches += k >= count[g] || m != expected[(size_t) g * MAX_PLIES + k];
+				k++;
+				continue;
+			}
+			mismatches += k != count[g] || r.winner != winner[g];
+			g++;
+			k = 0;
+		}
+	}
+	mismatches += g != games || log.games != (uint32_t) games;
+	/* #3 BOUNDED LOG: THE GAMES THAT DO NOT FIT ARE DROPPED WHOLE */
+	log_init(&log, bounded, sizeof(bounded), NULL);
+	for(g = 0; g < 20; g++)
+		log_random_game(&log, NULL, NULL);
+	log_reader_init(&r, bounded, log.length);
+	while((status = log_read(&r, &m)) != LOG_READ_MORE)
+		n += status == LOG_READ_BAD;
+	mismatches += n || r.games != log.games || log.games + log.lost != 20;
+	free(expected);
+	free(count);
+	free(winner);
+	return mismatches;
+}
+
+/**
+ * @brief Game logs: written (codes of the moves of random games) and read
+ * back with statistics (length, walls, winners), as for a database of games.
+ */
+static void bench_log(int scale) {
+	static uint8_t chunk[LOG_CHUNK];
+	GameLog log;
+	LogReader r;
+	Move m;
+	long games = 0, g, plies = 0, walls = 0, wins[3] = {0, 0, 0};
+	int pass, status;
+	uint8_t *copy;
+	uint32_t copy_length;
+	double start;
+
+	/* #1 THE GAMES */
+	stream_length = 0;
+	log_init(&log, chunk, sizeof(chunk), stream_sink);
+	for(g = 0; g < LOG_GAMES / 10 * scale; g++)
+		log_random_game(&log, NULL, NULL);
+	log_flush(&log);
+	copy_length = stream_length;
+	copy = malloc(copy_length);
+	if(!copy)
+		return;
+	memcpy(copy, stream, copy_length);
+	/* #2 READ WITH STATISTICS, 10 TIMES */
+	start = now();
+	for(pass = 0; pass < 10; pass++) {
+		log_reader_init(&r, copy, copy_length);
+		while((status = log_read(&r, &m)) != LOG_READ_MORE)
+			if(status == LOG_READ_MOVE)
+				walls += MOVE_IS_WALL(m);
+			else if(status == LOG_READ_END)
+				wins[r.winner]++;
+		games += r.games;
+		plies += r.moves;
+	}
+	report("log read + statistics", games, now() - start);
+	printf("%-30s %12.1f bytes/game, %.1f plies/game, %.1f walls/game, wins %ld/%ld\n", "",
+		(double) copy_length * 10 / games, (double) plies / games, (double) walls / games, wins[1], wins[2]);
+	/* #3 WRITE (THE SAME MOVES AGAIN), 10 TIMES */
+	start = now();
+	for(pass = 0; pass < 10; pass++) {
+		stream_length = 0;
+		log_init(&log, chunk, sizeof(chunk), stream_sink);
+		log_reader_init(&r, copy, copy_length);
+		while((status = log_read(&r, &m)) != LOG_READ_MORE)
+			if(status == LOG_READ_MOVE)
+				log_move(&log, m);
+			else
+				log_end_game(&log, r.winner);
+		log_flush(&log);
+	}
+	report("log read + write", games, now() - start);
+	sink += stream_length != copy_length || memcmp(stream, copy, copy_length);
+	free(copy);
+}
+
+/**
+ * @brief Replay the games of a log from the start position and compare the
+ * final position of each one with the expected key.
+ *
+ * @return The number of games that match (-1 if the log is not valid).
+ */
+static long replay_log(const GameLog *log, const uint64_t *final_key, long games) {
+	LogReader r;
+	Board b;
+	PathCache pc;
+	Move m;
+	long matches = 0;
+	int status;
+
+	log_reader_init(&r, log->data, log->length);
+	board_init(&b);
+	board_start(&b);
+	path_cache_init(&pc, &b);
+	while((status = log_read(&r, &m)) != LOG_READ_MORE) {
+		if(status == LOG_READ_BAD)
+			return -1;
+		if(status == LOG_READ_MOVE) {
+			board_play(&b, &pc, m);
+			continue;
+		}
+		matches += (long) r.games <= games && b.key == final_key[r.games - 1] && r.winner == board_winner(&b);
+		board_init(&b);
+		board_start(&b);
+		path_cache_init(&pc, &b);
+	}
+	return matches;
+}
+
+/**
+ * @brief Matches of the computer (player1, depth 2) against random moves
+ * (player2), played through computer_move and play_move as on the board. The
+ * moves are also played with board_play on a shadow board: the two must agree.
+ */
+static void bench_computer(void) {
+	static QuoridorGame game;
+	Search s;
+	MoveList list;
+	Board shadow;
+	PathCache shadow_pc;
+	Move m;
+	long games, plies = 0, wins[3] = {0, 0, 0}, mismatches = 0;
+	int ply;
+	uint64_t final_key[COMPUTER_GAMES];
+	static uint8_t log_buffer[COMPUTER_GAMES * (MAX_PLIES + 2)];
+	GameLog log;
+	double start = now();
+
+	search_init(&s);
+	s.max_depth = 2;
+	log_init(&log, log_buffer, sizeof(log_buffer), NULL);
+	game.log = &log;
+	for(games = 0; games < COMPUTER_GAMES; games++) {
+		initialize_board(&game);
+		start_game(&game);
+		shadow = game.board;
+		shadow_pc = game.paths;
+		for(ply = 0; ply < MAX_PLIES && !board_winner(&game.board); ply++) {
+			game.start_turn1 = ply % 2 == 0;
+			game.start_turn2 = !game.start_turn1;
+			if(game.start_turn1)
+				m = computer_move(&game, 1, &s);
+			else if(board_gen_moves(&game.board, &game.paths, 2, &list))
+				play_move(&game, m = list.move[next_random() % list.count]);
+			else
+				m = MOVE_NONE;
+			if(m != MOVE_NONE)
+				board_play(&shadow, &shadow_pc, m);
+			mismatches += shadow.key != game.board.key;
+		}
+		plies += ply;
+		wins[board_winner(&game.board)]++;
+		final_key[games] = game.board.key;
+	}
+	report("computer vs random", games, now() - start);
+	/* THE RECORD OF THE MATCHES, REPLAYED, ENDS IN THE SAME POSITIONS */
+	game.log = NULL;
+	log_end_game(&log, 0);
+	mismatches += COMPUTER_GAMES - replay_log(&log, final_key, COMPUTER_GAMES);
+	printf("%-30s %12.1f plies/game, wins %ld/%ld, unfinished %ld, %ld mismatches\n", "", (double) plies / games, wins[1], wins[2], wins[0], mismatches);
+}
+
+/**
+ * @brief Print the LCD traffic since the last call: transactions (lines,
+ * points, characters and block writes) and pixels.
+ */
+static void report_drawing(const char *name) {
+	static const GlcdStats zero;
+	printf("%-30s %8u transactions (%u lines, %u chars, %u blocks) %8u pixels\n", name,
+		glcd_stats.lines + glcd_stats.points + glcd_stats.texts + glcd_stats.blocks,
+		glcd_stats.lines, glcd_stats.texts, glcd_stats.blocks, glcd_stats.pixels);
+	glcd_stats = zero;
+}
+
+/**
+ * @brief Drawing cost of the steps of a match: start, a token move, a wall
+ * moved, rotated and placed, a tick of the timer.
+ */
+static void bench_drawing(void) {
+	static QuoridorGame game;
+	static const GlcdStats zero;
+	double start;
+	long i;
+
+	glcd_stats = zero;
+	draw_board();
+	show_info_layout();
+	initialize_board(&game);
+	start_game(&game);
+	draw_player(game.row_player1/2, game.col_player1/2, White);
+	draw_player(game.row_player2/2, game.col_player2/2, Red);
+	report_drawing("draw_board + start_game");
+	move_down_token(&game, 1);
+	report_drawing("move_down_token");
+	game.start_turn1 = 0;
+	game.start_turn2 = 1;
+	draw_wall(game.posx_wall, game.posy_wall, game.horizontal, Violet);
+	report_drawing("wall shown");
+	move_right_wall(&game, 2);
+	report_drawing("move_right_wall");
+	rotate_wall(&game);
+	report_drawing("rotate_wall");
+	position_wall(&game, 2);
+	report_drawing("position_wall");
+	show_timer(7);
+	report_drawing("show_timer");
+	/* TOKEN SPRITE (SPAN TABLE), DRAWN ON EVERY SQUARE IN TURN */
+	start = now();
+	for(i = 0; i < DRAW_OPS; i++)
+		draw_player(i % BOARD_DIMENSION, i / BOARD_DIMENSION % BOARD_DIMENSION, i & 1 ? White : Red);
+	report("draw_player", DRAW_OPS, now() - start);
+}
+
+int main(int argc, char *argv[]) {
+	int scale = argc > 1 ? atoi(argv[1]) : 1;
+	uint32_t tt_mb = argc > 2 ? (uint32_t) atoi(argv[2]) : 64;
+	uint32_t entries = (uint32_t) ((uint64_t) tt_mb * 1024 * 1024 / sizeof(TTSlot));
+	TTSlot *tt_buffer = malloc((size_t) (entries ? entries : 1) * sizeof(TTSlot));
+
+	if(scale < 1)
+		scale = 1;
+	if(!tt_buffer)
+		return 1;
+	zobrist_init();
+	tt_init(&tt, tt_buffer, entries ? entries : 1);
+	printf("board %dx%d, %d walls per player, %d-bit masks\n", BOARD_DIMENSION, BOARD_DIMENSION,
+		WALLS_PER_PLAYER, (int) sizeof(Bits) * 8);
+
+#ifdef QUORIDOR_SELFTEST
+	{
+		static QuoridorGame game;
+		int mismatches = check_trappola(&game, 1000, 1);
+		printf("%-30s %12d mismatches\n", "check_trappola (vs BFS)", mismatches);
+		if(mismatches)
+			return 1;
+	}
+#endif
+	{
+		int mismatches = check_keys(50);
+		printf("%-30s %12d mismatches\n", "zobrist keys (vs scratch)", mismatches);
+		if(mismatches)
+			return 1;
+	}
+	{
+		int mismatches = check_free_slots(50);
+		printf("%-30s %12d mismatches\n", "free wall slots (vs conflicts)", mismatches);
+		if(mismatches)
+			return 1;
+	}
+	build_samples();
+	{
+		int mismatches = check_log(200);
+		printf("%-30s %12d mismatches\n", "game log (write/read)", mismatches);
+		if(mismatches)
+			return 1;
+	}
+	{
+		int mismatches = check_make_unmake();
+		printf("%-30s %12d mismatches\n", "make/unmake (vs board_play)", mismatches);
+		if(mismatches)
+			return 1;
+	}
+	bench_movegen(scale);
+	bench_walls(scale, 1);
+	bench_walls(scale, 0);
+	bench_games(scale);
+	bench_make_unmake(scale);
+	bench_search(scale);
+	bench_mcts(scale);
+	bench_computer();
+	bench_log(scale);
+	bench_drawing();
+	free(tt_buffer);
+	return 0;
+}
@@ -0,0 +1,532 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "Engine/Engine.h"
+
+/* ***************   HOST DATABASE OF GAMES   *************** */
+/* Usage:
+		quoridor_db gen <log> <games> [seed]        random games to a game log
+		quoridor_db pack <db> [-d plies] <log>...   game logs to a database
+		quoridor_db stats <db>                      length and winners of the games
+		quoridor_db walls <db>                      win rate after each opening wall
+		quoridor_db position <db> [move]...         games through a position, next moves
+		quoridor_db check <db>                      index entries against the games
+	 The database is one file, read through a read-only mapping: the queries use
+	 the bytes of the file in place, nothing is parsed or copied. Layout (host
+	 byte order, every part aligned to 8 bytes):
+		header       DbHeader
+		offsets      uint64_t [games + 1], start of each game in the stream
+		stream       the games, bytes of the game log format (Engine.h)
+		index        DbEntry [index_entries], sorted by key
+	 The index holds the positions of the first 'index_plies' moves of every
+	 game, keyed by their Zobrist key (side to move included). Moves are written
+	 as the square of the token ("d2": column a-g, row 1-7) or as the orientation
+	 and the slot of the wall ("hc3", "vd5"). */
+
+#define DB_MAGIC "QRDB"
+#define DB_VERSION 1
+#define DB_INDEX_PLIES 16		/* DEFAULT DEPTH OF THE INDEX */
+#define DB_TOP 10						/* LINES OF THE TABLES */
+
+typedef struct {
+	char magic[4];
+	uint32_t version;
+	uint64_t games;
+	uint64_t stream_bytes;
+	uint64_t index_entries;
+	uint32_t index_plies;
+	uint32_t reserved;
+	uint64_t offsets_at, stream_at, index_at;		/* POSITIONS IN THE FILE */
+} DbHeader;
+
+/**
+ * @brief Position of the index: reached in game 'game' after its first 'pos'
+ * bytes (moves and passes), so the next move is the byte 'pos' of the game.
+ */
+typedef struct {
+	uint64_t key;
+	uint32_t game;
+	uint16_t pos;
+	uint16_t reserved;
+} DbEntry;
+
+typedef struct {
+	const DbHeader *header;
+	const uint64_t *offsets;
+	const uint8_t *stream;
+	const DbEntry *index;
+	void *map;
+	size_t size;
+} Db;
+
+static FILE *log_file;
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void *grow(void *p, size_t *capacity, size_t needed, size_t size) {
+	if(needed <= *capacity)
+		return p;
+	*capacity = needed * 2;
+	p = realloc(p, *capacity * size);
+	if(!p) {
+		fprintf(stderr, "out of memory\n");
+		exit(1);
+	}
+	return p;
+}
+
+/* ***************   NOTATION   *************** */
+
+static void move_name(Move m, char *name) {
+	if(MOVE_IS_WALL(m))
+		*name++ = MOVE_HORIZONTAL(m) ? 'h' : 'v';
+	*name++ = (char) ('a' + MOVE_X(m));
+	*name++ = (char) ('1' + MOVE_Y(m));
+	*name = 0;
+}
+
+/**
+ * @brief Move of a name, if legal in the position.
+ *
+ * @return The move, MOVE_NONE if the name is not a legal move.
+ */
+static Move move_parse(const char *name, const Board *b, PathCache *pc, int id_player) {
+	MoveList list;
+	char other[4];
+	int i;
+
+	board_gen_moves(b, pc, id_player, &list);
+	for(i = 0; i < list.count; i++) {
+		move_name(list.move[i], other);
+		if(!strcmp(name, other))
+			return list.move[i];
+	}
+	return MOVE_NONE;
+}
+
+/* ***************   GEN   *************** */
+
+static void file_sink(const uint8_t *data, uint32_t length) {
+	fwrite(data, 1, length, log_file);
+}
+
+static int cmd_gen(const char *path, long games, uint32_t seed) {
+	static uint8_t buffer[1 << 16];
+	GameLog log;
+	Board b;
+	PathCache pc;
+	MoveList list;
+	Move m;
+	long g;
+	int ply, id_player;
+	double start = now();
+
+	log_file = fopen(path, "wb");
+	if(!log_file) {
+		perror(path);
+		return 1;
+	}
+	if(!seed)
+		seed = 1;
+	log_init(&log, buffer, sizeof(buffer), file_sink);
+	for(g = 0; g < games; g++) {
+		board_init(&b);
+		board_start(&b);
+		path_cache_init(&pc, &b);
+		log_begin_game(&log);
+		for(ply = 0, id_player = 1; ply < 1000 && !board_winner(&b); ply++, id_player = 3 - id_player)
+			if(board_gen_moves(&b, &pc, id_player, &list)) {
+				seed ^= seed << 13;
+				seed ^= seed >> 17;
+				seed ^= seed << 5;
+				m = list.move[seed % list.count];
+				board_play(&b, &pc, m);
+				log_move(&log, m);
+			}
+		log_end_game(&log, board_winner(&b));
+	}
+	log_flush(&log);
+	if(fclose(log_file)) {
+		perror(path);
+		return 1;
+	}
+	printf("%ld games written to %s in %.2f s\n", games, path, now() - start);
+	return 0;
+}
+
+/* ***************   PACK   *************** */
+
+static int compare_entries(const void *a, const void *b) {
+	const DbEntry *x = a, *y = b;
+	if(x->key != y->key)
+		return x->key < y->key ? -1 : 1;
+	if(x->game != y->game)
+		return x->game < y->game ? -1 : 1;
+	return x->pos - y->pos;
+}
+
+static uint64_t align8(uint64_t n) {
+	return (n + 7) & ~(uint64_t) 7;
+}
+
+static int cmd_pack(const char *path, int index_plies, char **logs, int count) {
+	uint64_t *offsets = NULL;
+	uint8_t *stream = NULL;
+	DbEntry *index = NULL;
+	size_t offsets_cap = 0, stream_cap = 0, index_cap = 0;
+	size_t games = 0, stream_bytes = 0, entries = 0;
+	uint8_t *data;
+	LogReader r;
+	Board b;
+	PathCache pc;
+	Move m;
+	DbHeader h;
+	FILE *in, *out;
+	long size;
+	uint32_t game_at;
+	int i, status, plies;
+	double start = now();
+	static const uint8_t zero[8];
+
+	for(i = 0; i < count; i++) {
+		/* #1 A LOG, WHOLE IN MEMORY */
+		in = fopen(logs[i], "rb");
+		if(!in || fseek(in, 0, SEEK_END) || (size = ftell(in)) < 0 || fseek(in, 0, SEEK_SET)) {
+			perror(logs[i]);
+			return 1;
+		}
+		data = malloc(size ? size : 1);
+		if(!data || fread(data, 1, size, in) != (size_t) size) {
+			perror(logs[i]);
+			return 1;
+		}
+		fclose(in);
+		/* #2 GAMES REPLAYED: BYTES TO THE STREAM AS THEY ARE (PASSES INCLUDED),
+			 FIRST POSITIONS TO THE INDEX */
+		log_reader_init(&r, data, (uint32_t) size);
+		board_init(&b);
+		board_start(&b);
+		path_cache_init(&pc, &b);
+		game_at = plies = 0;
+		while((status = log_read(&r, &m)) != LOG_READ_MORE) {
+			if(status == LOG_READ_BAD) {
+				fprintf(stderr, "%s: not a game log (byte %u)\n", logs[i], r.pos - 1);
+				return 1;
+			}
+			if(status == LOG_READ_END) {
+				offsets = grow(offsets, &offsets_cap, games + 2, sizeof(uint64_t));
+				stream = grow(stream, &stream_cap, stream_bytes + r.pos - game_at, 1);
+				offsets[games++] = stream_bytes;
+				memcpy(stream + stream_bytes, data + game_at, r.pos - game_at);
+				stream_bytes += r.pos - game_at;
+				board_init(&b);
+				board_start(&b);
+				path_cache_init(&pc, &b);
+				game_at = r.pos;
+				plies = 0;
+				continue;
+			}
+			board_play(&b, &pc, m);
+			if(++plies <= index_plies && r.pos - game_at <= 0xFFFF) {
+				index = grow(index, &index_cap, entries + 1, sizeof(DbEntry));
+				index[entries].key = board_key(&b, r.side);
+				index[entries].game = (uint32_t) games;
+				index[entries].pos = (uint16_t) (r.pos - game_at);
+				index[entries].reserved = 0;
+				entries++;
+			}
+		}
+		if(r.pos != game_at) {
+			/* ITS POSITIONS ARE IN THE INDEX ALREADY: THE GAME IS KEPT AS UNFINISHED */
+			fprintf(stderr, "%s: last game not closed, kept as unfinished\n", logs[i]);
+			offsets = grow(offsets, &offsets_cap, games + 2, sizeof(uint64_t));
+			stream = grow(stream, &stream_cap, stream_bytes + r.pos - game_at + 1, 1);
+			offsets[games++] = stream_bytes;
+			memcpy(stream + stream_bytes, data + game_at, r.pos - game_at);
+			stream_bytes += r.pos - game_at;
+			stream[stream_bytes++] = LOG_END;
+		}
+		free(data);
+	}
+	offsets = grow(offsets, &offsets_cap, games + 1, sizeof(uint64_t));
+	offsets[games] = stream_bytes;
+	qsort(index, entries, sizeof(DbEntry), compare_entries);
+	/* #3 THE FILE */
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, DB_MAGIC, 4);
+	h.version = DB_VERSION;
+	h.games = games;
+	h.stream_bytes = stream_bytes;
+	h.index_entries = entries;
+	h.index_plies = (uint32_t) index_plies;
+	h.offsets_at = align8(sizeof(h));
+	h.stream_at = h.offsets_at + (games + 1) * sizeof(uint64_t);
+	h.index_at = align8(h.stream_at + stream_bytes);
+	out = fopen(path, "wb");
+	if(!out) {
+		perror(path);
+		return 1;
+	}
+	fwrite(&h, sizeof(h), 1, out);
+	fwrite(zero, 1, h.offsets_at - sizeof(h), out);
+	fwrite(offsets, sizeof(uint64_t), games + 1, out);
+	fwrite(stream, 1, stream_bytes, out);
+	fwrite(zero, 1, h.index_at - h.stream_at - stream_bytes, out);
+	fwrite(index, sizeof(DbEntry), entries, out);
+	if(fclose(out)) {
+		perror(path);
+		return 1;
+	}
+	printf("%lu games, %lu bytes of moves, %lu positions indexed (first %d plies) in %.2f s\n",
+		(unsigned long) games, (unsigned long) stream_bytes, (unsigned long) entries, index_plies, now() - start);
+	free(offsets);
+	free(stream);
+	free(index);
+	return 0;
+}
+
+/* ***************   QUERIES (ON THE MAPPING)   *************** */
+
+static int db_open(Db *db, const char *path) {
+	struct stat st;
+	int fd = open(path, O_RDONLY);
+
+	if(fd < 0 || fstat(fd, &st)) {
+		perror(path);
+		return 0;
+	}
+	db->size = (size_t) st.st_size;
+	db->map = db->size >= sizeof(DbHeader) ? mmap(NULL, db->size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+	close(fd);
+	if(db->map == MAP_FAILED) {
+		fprintf(stderr, "%s: cannot map\n", path);
+		return 0;
+	}
+	db->header = db->map;
+	if(memcmp(db->header->magic, DB_MAGIC, 4) || db->header->version != DB_VERSION
+			|| db->header->index_at + db->header->index_entries * sizeof(DbEntry) > db->size) {
+		fprintf(stderr, "%s: not a database of games\n", path);
+		munmap(db->map, db->size);
+		return 0;
+	}
+	db->offsets = (const uint64_t *) ((const uint8_t *) db->map + db->header->offsets_at);
+	db->stream = (const uint8_t *) db->map + db->header->stream_at;
+	db->index = (const DbEntry *) ((const uint8_t *) db->map + db->header->index_at);
+	return 1;
+}
+
+static int db_winner(const Db *db, uint64_t game) {
+	return db->stream[db->offsets[game + 1] - 1] & 3;
+}
+
+static int cmd_stats(const Db *db) {
+	uint64_t g, games = db->header->games, wins[3] = {0, 0, 0}, walls = 0, bytes;
+	const uint8_t *p, *end;
+	double start = now();
+
+	for(g = 0; g < games; g++) {
+		wins[db_winner(db, g)]++;
+		for(p = db->stream + db->offsets[g], end = db->stream + db->offsets[g + 1] - 1; p < end; p++)
+			walls += *p >= LOG_WALL_CODE && *p < LOG_PASS;
+	}
+	bytes = db->header->stream_bytes - games;
+	printf("%llu games, %.1f plies/game, %.1f walls/game\n", (unsigned long long) games,
+		games ? (double) bytes / games : 0, games ? (double) walls / games : 0);
+	printf("wins player1 %.1f%%, player2 %.1f%%, unfinished %.1f%%\n",
+		games ? 100.0 * wins[1] / games : 0, games ? 100.0 * wins[2] / games : 0, games ? 100.0 * wins[0] / games : 0);
+	printf("%.3f s (%.0f games/s)\n", now() - start, games / (now() - start));
+	return 0;
+}
+
+/**
+ * @brief 95% confidence interval of a win rate (normal approximation), in %.
+ */
+static double margin(uint64_t wins, uint64_t games) {
+	double p = games ? (double) wins / games : 0;
+	return games ? 196 * sqrt(p * (1 - p) / games) : 0;
+}
+
+static int cmd_walls(const Db *db) {
+	static uint64_t count[2][LOG_PASS], wins[2][LOG_PASS];
+	uint64_t g, games = db->header->games;
+	const uint8_t *p, *end;
+	int side, code, k, best, n;
+	char name[4];
+	double start = now();
+
+	/* #1 FIRST WALL OF EACH GAME, BY PLAYER */
+	for(g = 0; g < games; g++)
+		for(p = db->stream + db->offsets[g], end = db->stream + db->offsets[g + 1] - 1, side = 0; p < end; p++, side ^= 1)
+			if(*p >= LOG_WALL_CODE && *p < LOG_PASS) {
+				count[side][*p]++;
+				wins[side][*p] += db_winner(db, g) == side + 1;
+				break;
+			}
+	/* #2 THE MOST PLAYED ONES */
+	printf("opening wall      games   win rate of its player\n");
+	for(n = 0; n < DB_TOP; n++) {
+		best = -1;
+		for(k = 0; k < 2 * LOG_PASS; k++)
+			if(count[k & 1][k >> 1] && (best < 0 || count[k & 1][k >> 1] > count[best & 1][best >> 1]))
+				best = k;
+		if(best < 0)
+			break;
+		side = best & 1;
+		code = best >> 1;
+		move_name(log_decode(code, side + 1), name);
+		printf("P%d %-4s     %10llu   %5.1f%% +- %.1f\n", side + 1, name, (unsigned long long) count[side][code],
+			100.0 * wins[side][code] / count[side][code], margin(wins[side][code], count[side][code]));
+		count[side][code] = 0;
+	}
+	printf("%.3f s\n", now() - start);
+	return 0;
+}
+
+/**
+ * @brief First entry of the index with a key (binary search).
+ */
+static uint64_t db_lower_bound(const Db *db, uint64_t key) {
+	uint64_t lo = 0, hi = db->header->index_entries, mid;
+	while(lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if(db->index[mid].key < key)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+static int cmd_position(const Db *db, char **names, int count) {
+	static uint64_t next[LOG_PASS + 1], next_wins[LOG_PASS + 1];
+	Board b;
+	PathCache pc;
+	Move m;
+	uint64_t key, e, games = 0, wins[3] = {0, 0, 0};
+	int i, id_player = 1, code, best, n;
+	char name[4];
+	double start;
+
+	board_init(&b);
+	board_start(&b);
+	path_cache_init(&pc, &b);
+	for(i = 0; i < count; i++, id_player = 3 - id_player) {
+		m = move_parse(names[i], &b, &pc, id_player);
+		if(m == MOVE_NONE) {
+			fprintf(stderr, "%s: not a legal move of player%d\n", names[i], id_player);
+			return 1;
+		}
+		board_play(&b, &pc, m);
+	}
+	if(count > (int) db->header->index_plies)
+		printf("warning: only the first %u plies are indexed\n", db->header->index_plies);
+	/* ALL THE ENTRIES OF THE KEY: WINNERS AND NEXT MOVES */
+	start = now();
+	key = board_key(&b, id_player);
+	for(e = db_lower_bound(db, key); e < db->header->index_entries && db->index[e].key == key; e++) {
+		const DbEntry *d = &db->index[e];
+		int winner = db_winner(db, d->game);
+		games++;
+		wins[winner]++;
+		code = db->stream[db->offsets[d->game] + d->pos];
+		code = code < LOG_PASS ? code : LOG_PASS;		/* PASS OR END */
+		next[code]++;
+		next_wins[code] += winner == id_player;
+	}
+	printf("%llu games (lookup %.1f us): player1 %.1f%%, player2 %.1f%%, unfinished %.1f%%\n",
+		(unsigned long long) games, (now() - start) * 1e6, games ? 100.0 * wins[1] / games : 0,
+		games ? 100.0 * wins[2] / games : 0, games ? 100.0 * wins[0] / games : 0);
+	for(n = 0; n < DB_TOP; n++) {
+		best = -1;
+		for(code = 0; code <= LOG_PASS; code++)
+			if(next[code] && (best < 0 || next[code] > next[best]))
+				best = code;
+		if(best < 0)
+			break;
+		if(best == LOG_PASS)
+			strcpy(name, "-");
+		else
+			move_name(log_decode(best, id_player), name);
+		printf("  next %-4s %10llu   %5.1f%% +- %.1f for player%d\n", name, (unsigned long long) next[best],
+			100.0 * next_wins[best] / next[best], margin(next_wins[best], next[best]), id_player);
+		next[best] = 0;
+	}
+	return 0;
+}
+
+/**
+ * @brief Every entry of the index must be the key of the game replayed up to
+ * its position.
+ */
+static int cmd_check(const Db *db) {
+	uint64_t e, errors = 0;
+	LogReader r;
+	Board b;
+	PathCache pc;
+	Move m;
+	double start = now();
+
+	for(e = 0; e < db->header->index_entries; e++) {
+		const DbEntry *d = &db->index[e];
+		log_reader_init(&r, db->stream + db->offsets[d->game], d->pos);
+		board_init(&b);
+		board_start(&b);
+		path_cache_init(&pc, &b);
+		while(log_read(&r, &m) == LOG_READ_MOVE)
+			board_play(&b, &pc, m);
+		errors += board_key(&b, r.side) != d->key || (e && db->index[e - 1].key > d->key);
+	}
+	printf("%llu entries, %llu errors, %.2f s\n", (unsigned long long) db->header->index_entries,
+		(unsigned long long) errors, now() - start);
+	return errors != 0;
+}
+
+static int usage(void) {
+	fprintf(stderr, "usage: quoridor_db gen <log> <games> [seed]\n"
+		"       quoridor_db pack <db> [-d plies] <log>...\n"
+		"       quoridor_db stats|walls|check <db>\n"
+		"       quoridor_db position <db> [move]...\n");
+	return 2;
+}
+
+int main(int argc, char *argv[]) {
+	Db db;
+	int result, plies = DB_INDEX_PLIES, first = 3;
+
+	if(argc < 3)
+		return usage();
+	zobrist_init();
+	if(!strcmp(argv[1], "gen"))
+		return argc < 4 ? usage() : cmd_gen(argv[2], atol(argv[3]), argc > 4 ? (uint32_t) strtoul(argv[4], NULL, 0) : 2463534242u);
+	if(!strcmp(argv[1], "pack")) {
+		if(argc > 4 && !strcmp(argv[3], "-d")) {
+			plies = atoi(argv[4]);
+			first = 5;
+		}
+		return first >= argc ? usage() : cmd_pack(argv[2], plies, argv + first, argc - first);
+	}
+	if(!db_open(&db, argv[2]))
+		return 1;
+	if(!strcmp(argv[1], "stats"))
+		result = cmd_stats(&db);
+	else if(!strcmp(argv[1], "walls"))
+		result = cmd_walls(&db);
+	else if(!strcmp(argv[1], "position"))
+		result = cmd_position(&db, argv + 3, argc - 3);
+	else if(!strcmp(argv[1], "check"))
+		result = cmd_check(&db);
+	else
+		result = usage();
+	munmap(db.map, db.size);
+	return result;
+}
@@ -0,0 +1,294 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "GLCD/GLCD.h"
+#include "Render/Framebuffer.h"
+#include "c_functions.h"
+#ifdef RENDER_DIRTY
+#include "Render/Render.h"
+#endif
+
+/* ***************   HOST FRAME TESTS OF THE DRAWING CODE   *************** */
+/* Usage: quoridor_frames [-u] [scale]. Built with FRAMEBUFFER: the game draws
+	 into the off-screen framebuffer of Render/. A scripted match (fixed seed)
+	 stops at a few key frames, each compared pixel by pixel with its golden
+	 image (golden/<frame>.ppm, next to the program). A frame that differs is
+	 saved as <frame>.ppm in the current folder, together with <frame>.diff.ppm
+	 (changed pixels in magenta). With -u the goldens are written instead. Then
+	 frames per second of the drawing pipeline, 'scale' times the default frames. */
+
+#define FRAMES 200			/* FRAMES OF EACH THROUGHPUT BENCHMARK */
+#define MAX_PLIES 200		/* THE SCRIPTED MATCH IS STOPPED AFTER THIS */
+#define PATH_LENGTH 512
+
+static QuoridorGame game;
+static uint32_t seed = 2463534242u;
+static char golden_dir[PATH_LENGTH];
+static int update;
+
+static uint32_t next_random(void) {
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void report(const char *name, long frames, double seconds, uint32_t pixels) {
+	printf("%-30s %12ld frames %8.1f us/frame %10.0f frames/s %8lu px/frame\n", name, frames,
+		seconds * 1e6 / frames, frames / seconds, (unsigned long) (pixels / frames));
+}
+
+/* ***************   PPM IMAGES   *************** */
+
+/**
+ * @brief RGB565 -> 8 bits per channel.
+ */
+static void to_rgb(uint16_t c, uint8_t *rgb) {
+	rgb[0] = (uint8_t) ((c >> 11) * 255 / 31);
+	rgb[1] = (uint8_t) ((c >> 5 & 0x3F) * 255 / 63);
+	rgb[2] = (uint8_t) ((c & 0x1F) * 255 / 31);
+}
+
+/**
+ * @brief Write an image of the display size (binary PPM, P6).
+ *
+ * @return 1 if written, 0 otherwise.
+ */
+static int write_ppm(const char *path, const uint8_t *rgb) {
+	FILE *f = fopen(path, "wb");
+	int ok;
+
+	if(!f)
+		return 0;
+	fprintf(f, "P6\n%d %d\n255\n", MAX_X, MAX_Y);
+	ok = fwrite(rgb, 3, MAX_X * MAX_Y, f) == MAX_X * MAX_Y;
+	return fclose(f) == 0 && ok;
+}
+
+/**
+ * @brief Read an image of the display size written by write_ppm.
+ *
+ * @return 1 if read, 0 if missing or of another size.
+ */
+static int read_ppm(const char *path, uint8_t *rgb) {
+	FILE *f = fopen(path, "rb");
+	int w, h, max, ok;
+
+	if(!f)
+		return 0;
+	ok = fscanf(f, "P6 %d %d %d", &w, &h, &max) == 3 && w == MAX_X && h == MAX_Y && max == 255
+		&& fgetc(f) != EOF && fread(rgb, 3, MAX_X * MAX_Y, f) == MAX_X * MAX_Y;
+	fclose(f);
+	return ok;
+}
+
+/**
+ * @brief Compare the framebuffer with the golden image of a frame (or write
+ * it, with -u). The framebuffer is flushed first, as on the board.
+ *
+ * @return The number of pixels that differ (0 when updating).
+ */
+static long check_frame(const char *name) {
+	static uint8_t actual[MAX_Y * MAX_X * 3], golden[MAX_Y * MAX_X * 3];
+	char path[PATH_LENGTH + 64];
+	long diff = 0, i;
+	int x0 = MAX_X, y0 = MAX_Y, x1 = -1, y1 = -1, x, y;
+
+	fb_flush();
+	for(y = 0; y < MAX_Y; y++)
+		for(x = 0; x < MAX_X; x++)
+			to_rgb(fb_pixels[y][x], &actual[(y * MAX_X + x) * 3]);
+	sprintf(path, "%s/%s.ppm", golden_dir, name);
+	if(update) {
+		if(!write_ppm(path, actual)) {
+			printf("%-30s cannot write %s\n", name, path);
+			return 1;
+		}
+		printf("%-30s written %s\n", name, path);
+		return 0;
+	}
+	if(!read_ppm(path, golden)) {
+		printf("%-30s no golden %s (run with -u)\n", name, path);
+		return 1;
+	}
+	/* DIFF: CHANGED PIXELS IN MAGENTA, THE OTHERS DIMMED */
+	for(i = 0; i < MAX_X * MAX_Y; i++) {
+		if(memcmp(&actual[i * 3], &golden[i * 3], 3)) {
+			diff++;
+			x = i % MAX_X;
+			y = i / MAX_X;
+			if(x < x0) x0 = x;
+			if(y < y0) y0 = y;
+			if(x > x1) x1 = x;
+			if(y > y1) y1 = y;
+			golden[i * 3] = golden[i * 3 + 2] = 255;
+			golden[i * 3 + 1] = 0;
+		} else {
+			golden[i * 3] /= 4;
+			golden[i * 3 + 1] /= 4;
+			golden[i * 3 + 2] /= 4;
+		}
+	}
+	if(!diff) {
+		printf("%-30s %12d pixels differ\n", name, 0);
+		return 0;
+	}
+	printf("%-30s %12ld pixels differ in (%d, %d)-(%d, %d), see %s.ppm and %s.diff.ppm\n",
+		name, diff, x0, y0, x1, y1, name, name);
+	sprintf(path, "%s.ppm", name);
+	write_ppm(path, actual);
+	sprintf(path, "%s.diff.ppm", name);
+	write_ppm(path, golden);
+	return diff;
+}
+
+/* ***************   SCRIPTED MATCH   *************** */
+
+/**
+ * @brief Display and game at the start of a match (as after the first touch
+ * on the board).
+ */
+static void script_start(void) {
+	new_match(&game);
+	show_timer(20);
+}
+
+/**
+ * @brief One ply of the scripted match: sometimes a wall preview moved around
+ * and taken back, then a random legal move and the highlight of the moves of
+ * the other player.
+ *
+ * @param preview  1 to leave the wall preview on the display (no move played).
+ */
+static void script_ply(int ply, int preview) {
+	MoveList list;
+	int id = 1 + ply % 2, k;
+
+	game.start_turn1 = id == 1;
+	game.start_turn2 = id == 2;
+	show_timer(20 - ply % 20);
+	if(preview || next_random() % 3 == 0) {
+		draw_wall(game.posx_wall, game.posy_wall, game.horizontal, id == 1 ? Hazelnut : Violet);
+		for(k = 0; k < 4; k++)
+			switch(next_random() % 5) {
+				case 0: move_down_wall(&game, id); break;
+				case 1: move_up_wall(&game, id); break;
+				case 2: move_left_wall(&game, id); break;
+				case 3: move_right_wall(&game, id); break;
+				default: rotate_wall(&game);
+			}
+		if(preview)
+			return;
+		draw_wall(game.posx_wall, game.posy_wall, game.horizontal, Black);
+		if(game.is_previous_overlapped)
+			redraw_walls(&game);
+	}
+	if(board_gen_moves(&game.board, &game.paths, id, &list))
+		play_move(&game, list.move[next_random() % list.count]);
+	possible_moves(&game, ROW_OF(game.board.pawn[2 - id]), COL_OF(game.board.pawn[2 - id]), id == 1 ? Red : Lavanda);
+}
+
+/**
+ * @brief The scripted match, checked at its key frames.
+ *
+ * @return The total number of pixels that differ from the goldens.
+ */
+static long check_frames(void) {
+	long diff = 0;
+	int ply;
+
+	seed = 2463534242u;
+	script_start();
+	diff += check_frame("start");
+	for(ply = 0; ply < 16; ply++)
+		script_ply(ply, 0);
+	diff += check_frame("opening");
+	script_ply(ply, 1);
+	diff += check_frame("wall_preview");
+	draw_wall(game.posx_wall, game.posy_wall, game.horizontal, Black);
+	if(game.is_previous_overlapped)
+		redraw_walls(&game);
+	for(ply++; ply < MAX_PLIES && !board_winner(&game.board); ply++)
+		script_ply(ply, 0);
+	diff += check_frame("end");
+	return diff;
+}
+
+/* ***************   THROUGHPUT   *************** */
+
+static void bench_frames(int scale) {
+	long frames = FRAMES * scale, i;
+	uint32_t pixels = 0;
+	double start;
+
+	/* #1 FULL FRAME: BOARD, INFO PANELS, TOKENS, FLUSH */
+	start = now();
+	for(i = 0; i < frames; i++) {
+		script_start();
+		pixels += fb_flush();
+	}
+	report("full frame", frames, now() - start, pixels);
+	/* #2 TOKEN MOVED DOWN AND UP AGAIN, WITH THE HIGHLIGHT OF ITS MOVES */
+	script_start();
+	fb_flush();
+	pixels = 0;
+	start = now();
+	for(i = 0; i < frames; i++) {
+		if(i % 2 == 0)
+			move_down_token(&game, 1);
+		else
+			move_up_token(&game, 1);
+		possible_moves(&game, game.row_player1/2, game.col_player1/2, Lavanda);
+		pixels += fb_flush();
+	}
+	report("token move", frames, now() - start, pixels);
+	/* #3 WALL PREVIEW MOVED RIGHT AND LEFT AGAIN */
+	game.start_turn1 = 0;
+	game.start_turn2 = 1;
+	draw_wall(game.posx_wall, game.posy_wall, game.horizontal, Violet);
+	fb_flush();
+	pixels = 0;
+	start = now();
+	for(i = 0; i < frames; i++) {
+		if(i % 2 == 0)
+			move_right_wall(&game, 2);
+		else
+			move_left_wall(&game, 2);
+		pixels += fb_flush();
+	}
+	report("wall preview move", frames, now() - start, pixels);
+}
+
+int main(int argc, char *argv[]) {
+	const char *slash = strrchr(argv[0], '/');
+	int scale = 1, i;
+	long diff;
+
+	for(i = 1; i < argc; i++)
+		if(!strcmp(argv[i], "-u"))
+			update = 1;
+		else
+			scale = atoi(argv[i]);
+	if(scale < 1)
+		scale = 1;
+	zobrist_init();
+	/* GOLDENS NEXT TO THE PROGRAM */
+	if(slash && slash - argv[0] < PATH_LENGTH - 8)
+		sprintf(golden_dir, "%.*s/golden", (int) (slash - argv[0]), argv[0]);
+	else
+		strcpy(golden_dir, "golden");
+
+	diff = check_frames();
+	if(diff)
+		return 1;
+	if(!update)
+		bench_frames(scale);
+	return 0;
+}
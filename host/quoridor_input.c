@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include "GLCD/GLCD.h"
+#include "c_functions.h"
+#include "Input/Input.h"
+
+/* ***************   HOST BENCHMARK OF THE INPUT RING   *************** */
+/* Usage: quoridor_input [-n events] [-b burst] [-s seed] [-w file] [-r file]
+	 A stream of input events (random from 'seed', or read with -r from a file
+	 written by -w, one byte per event) is played on a match at full speed:
+	 pushed into the ring in bursts of 'burst' events, as the interrupt handlers
+	 would do, then drained by the dispatcher. Reported: cost of a push (what an
+	 interrupt handler now pays), cost of a dispatch (average and worst, what the
+	 main loop pays), events lost with bursts larger than the ring and a run with
+	 the producer in a thread of its own, which must play exactly the stream of
+	 the single-threaded run and reach the same position. */
+
+#define DEFAULT_EVENTS 200000
+
+static QuoridorGame game;
+static uint8_t *events;
+static int count;
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint32_t next_random(uint64_t *state) {
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+	return (uint32_t) (*state >> 32);
+}
+
+/**
+ * @brief Random stream: mostly joystick, some buttons, one tick out of eight
+ * (turns lost now and then) and touches to start a new match after a win.
+ */
+static void generate(int n, uint64_t seed) {
+	static const uint8_t weights[INPUT_EVENTS] = { 0, 1, 8, 8, 8, 8, 4, 2, 2, 6 };
+	int i, e, total = 0, r;
+
+	for(e = 0; e < INPUT_EVENTS; e++)
+		total += weights[e];
+	for(i = 0; i < n; i++) {
+		r = (int) (next_random(&seed) % (uint32_t) total);
+		for(e = 0; r >= weights[e]; e++)
+			r -= weights[e];
+		events[i] = (uint8_t) e;
+	}
+	events[0] = INPUT_TOUCH;
+}
+
+/**
+ * @brief New match state: nothing started, empty ring.
+ */
+static void reset(void) {
+	memset(&game, 0, sizeof(game));
+	input_init(&input_queue);
+}
+
+typedef struct {
+	double push_ns, dispatch_ns, max_ns, seconds;
+	int played, matches;
+	uint32_t dropped;
+	uint64_t key;
+} Result;
+
+/**
+ * @brief Single-threaded run: bursts of 'burst' pushes, then the ring drained
+ * one event at a time (each dispatch timed).
+ */
+static void run(Result *r, int burst) {
+	double start, t, push = 0, dispatch = 0;
+	int i, j, event, started;
+
+	reset();
+	memset(r, 0, sizeof(*r));
+	start = now();
+	for(i = 0; i < count; i += burst) {
+		t = now();
+		for(j = i; j < count && j < i + burst; j++)
+			input_push(&input_queue, events[j]);
+		push += now() - t;
+		for(;;) {
+			t = now();
+			if((event = input_pop(&input_queue)) < 0)
+				break;
+			started = game.start_match;
+			input_dispatch(&game, event);
+			t = now() - t;
+			dispatch += t;
+			if(t * 1e9 > r->max_ns)
+				r->max_ns = t * 1e9;
+			r->played++;
+			r->matches += started && !game.start_match;
+		}
+	}
+	r->seconds = now() - start;
+	r->push_ns = push * 1e9 / count;
+	r->dispatch_ns = r->played ? dispatch * 1e9 / r->played : 0;
+	r->dropped = input_queue.dropped;
+	r->key = board_compute_key(&game.board);
+}
+
+/**
+ * @brief Producer of the threaded run (the interrupt handlers): every event of
+ * the stream, retried while the ring is full.
+ */
+static void *producer_main(void *arg) {
+	int i;
+
+	(void) arg;
+	for(i = 0; i < count; i++)
+		while(!input_push(&input_queue, events[i]))
+			sched_yield();		/* RING FULL: LET THE CONSUMER RUN */
+	return NULL;
+}
+
+/**
+ * @brief Threaded run: the main thread drains while the producer pushes.
+ *
+ * @return The number of events played in the order of the stream (all of them
+ * if the ring kept the order).
+ */
+static int run_threaded(Result *r) {
+	pthread_t thread;
+	double start;
+	int event, in_order = 0;
+
+	reset();
+	memset(r, 0, sizeof(*r));
+	start = now();
+	if(pthread_create(&thread, NULL, producer_main, NULL))
+		return -1;
+	while(r->played < count) {
+		if((event = input_pop(&input_queue)) < 0) {
+			sched_yield();
+			continue;
+		}
+		in_order += event == events[r->played];
+		input_dispatch(&game, event);
+		r->played++;
+	}
+	pthread_join(thread, NULL);
+	r->seconds = now() - start;
+	r->key = board_compute_key(&game.board);
+	return in_order;
+}
+
+static int usage(void) {
+	fprintf(stderr, "usage: quoridor_input [-n events] [-b burst] [-s seed] [-w file] [-r file]\n");
+	return 2;
+}
+
+int main(int argc, char *argv[]) {
+	int n = DEFAULT_EVENTS, burst = 8, i, in_order;
+	uint64_t seed = 88172645463325252ULL;
+	const char *write_file = NULL, *read_file = NULL;
+	FILE *f;
+	Result single, overflow, threaded;
+
+	for(i = 1; i < argc; i++) {
+		if(i + 1 >= argc || argv[i][0] != '-' || argv[i][2])
+			return usage();
+		switch(argv[i][1]) {
+			case 'n': n = atoi(argv[++i]); break;
+			case 'b': burst = atoi(argv[++i]); break;
+			case 's': seed = strtoull(argv[++i], NULL, 0); break;
+			case 'w': write_file = argv[++i]; break;
+			case 'r': read_file = argv[++i]; break;
+			default: return usage();
+		}
+	}
+	if(n < 1 || burst < 1 || burst > INPUT_QUEUE_SIZE)
+		return usage();
+	zobrist_init();
+
+	/* #1 THE STREAM: READ, OR GENERATED (AND WRITTEN IF ASKED) */
+	if(read_file) {
+		if(!(f = fopen(read_file, "rb")))
+			return 1;
+		fseek(f, 0, SEEK_END);
+		n = (int) ftell(f);
+		rewind(f);
+		events = malloc(n > 0 ? (size_t) n : 1);
+		count = events ? (int) fread(events, 1, (size_t) n, f) : 0;
+		fclose(f);
+		for(i = 0; i < count; i++)
+			if(events[i] >= INPUT_EVENTS)
+				events[i] = 0;		/* UNKNOWN CODE: IGNORED BY THE DISPATCHER */
+	} else {
+		if(!(events = malloc((size_t) n)))
+			return 1;
+		generate(n, seed);
+		count = n;
+	}
+	if(count < 1)
+		return 1;
+	if(write_file) {
+		if(!(f = fopen(write_file, "wb")) || fwrite(events, 1, (size_t) count, f) != (size_t) count)
+			return 1;
+		fclose(f);
+	}
+
+	/* #2 THE RUNS */
+	run(&single, burst);
+	printf("%d events, ring of %d, bursts of %d\n", count, INPUT_QUEUE_SIZE, burst);
+	printf("%-24s %10.1f ns/event\n", "push (interrupt)", single.push_ns);
+	printf("%-24s %10.1f ns/event (worst %.0f ns)\n", "dispatch (main loop)", single.dispatch_ns, single.max_ns);
+	printf("%-24s %10.0f events/s, %d matches won\n", "throughput", single.played / single.seconds, single.matches);
+	printf("%-24s %10u (played %d)\n", "lost events", single.dropped, single.played);
+
+	run(&overflow, 2 * INPUT_QUEUE_SIZE);
+	printf("%-24s %10u of %d (bursts of %d)\n", "lost events", overflow.dropped, count, 2 * INPUT_QUEUE_SIZE);
+
+	in_order = run_threaded(&threaded);
+	printf("%-24s %10.0f events/s, %d of %d in order, final position %s\n", "producer thread",
+		threaded.played / threaded.seconds, in_order, count, threaded.key == single.key ? "ok" : "MISMATCH");
+	free(events);
+	return single.dropped || in_order != count || threaded.key != single.key;
+}
@@ -0,0 +1,221 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "GLCD/GLCD.h"
+#include "c_functions.h"
+
+/* ***************   HOST PERFT OF THE MOVE GENERATOR   *************** */
+/* Usage: quoridor_perft [-d] [-c] [depth]
+	 Counts the positions reached after 1, 2, ..., 'depth' plies from the start
+	 position set up by start_game (board_perft of Engine/), with the time and
+	 the positions per second of each depth. The counts are compared with the
+	 reference ones below: any change of the rules or of the generator (face to
+	 face jumps, overlaps, traps, incremental updates) shows up as a mismatch.
+	 -d  per-move breakdown of the last depth: the positions under each move of
+	     player1 ("d2": square of the token, "hc3"/"vd5": wall and its slot)
+	 -c  the same counts through the functions of the game (possible_moves and
+	     move_*_token, is_overlapped_wall, is_trappola and position_wall), on
+	     copies of the match: much slower, use it with small depths */
+
+#define DEFAULT_DEPTH 4
+
+/* POSITIONS AFTER 1, 2, ... PLIES FROM THE START (INDEX 0: THE START ITSELF),
+	 FOR EACH SIZE OF THE BOARD (9x9: SAME COUNTS WITH -c) */
+#if BOARD_DIMENSION == 7
+static const uint64_t reference[] = {1, 75, 5357, 363872, 23458826, 1433048115ULL};
+#elif BOARD_DIMENSION == 9
+static const uint64_t reference[] = {1, 131, 16677, 2062264, 247569030ULL};
+#else
+static const uint64_t reference[] = {1};
+#endif
+
+#define REFERENCE_DEPTH ((int) (sizeof(reference) / sizeof(reference[0])) - 1)
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void move_name(Move m, char *name) {
+	if(MOVE_IS_WALL(m))
+		*name++ = MOVE_HORIZONTAL(m) ? 'h' : 'v';
+	*name++ = (char) ('a' + MOVE_X(m));
+	*name++ = (char) ('1' + MOVE_Y(m));
+	*name = 0;
+}
+
+/* ***************   PERFT THROUGH THE GAME   *************** */
+
+/**
+ * @brief Legal moves of the player to move, found through the functions of
+ * the game: the flags of possible_moves for the token, is_overlapped_wall and
+ * is_trappola (both players) for every position of the wall.
+ *
+ * @return The number of moves.
+ */
+static int game_moves(QuoridorGame *game, int id_player, MoveList *list) {
+	int row = id_player == 1 ? game->row_player1/2 : game->row_player2/2;
+	int col = id_player == 1 ? game->col_player1/2 : game->col_player2/2;
+	int sq = SQUARE(row, col), x, y;
+
+	list->count = 0;
+	possible_moves(game, row, col, Black);
+	if(game->possible_down)
+		list->move[list->count++] = MOVE_PAWN(id_player, sq + (game->f2f_down ? 2 : 1) * step_offset[DIR_DOWN]);
+	if(game->possible_left)
+		list->move[list->count++] = MOVE_PAWN(id_player, sq + (game->f2f_left ? 2 : 1) * step_offset[DIR_LEFT]);
+	if(game->possible_right)
+		list->move[list->count++] = MOVE_PAWN(id_player, sq + (game->f2f_right ? 2 : 1) * step_offset[DIR_RIGHT]);
+	if(game->possible_up)
+		list->move[list->count++] = MOVE_PAWN(id_player, sq + (game->f2f_up ? 2 : 1) * step_offset[DIR_UP]);
+	if(game->board.walls[id_player - 1] <= 0)
+		return list->count;
+	/* POSITIONS OF THE WALL AS FOR THE JOYSTICK: posx FROM -1 (HORIZONTAL), posy FROM -1 (VERTICAL) */
+	for(game->horizontal = 1; game->horizontal >= 0; game->horizontal--)
+		for(y = -!game->horizontal; y < WALL_DIMENSION - !game->horizontal; y++)
+			for(x = -game->horizontal; x < WALL_DIMENSION - game->horizontal; x++)
+				if(!is_overlapped_wall(game, x, y) && !is_trappola(game, 1, x, y) && !is_trappola(game, 2, x, y))
+					list->move[list->count++] = MOVE_WALL(id_player, game->horizontal, SLOT(y + !game->horizontal, x + game->horizontal));
+	return list->count;
+}
+
+/**
+ * @brief board_perft on a match: each move is played on a copy of the match,
+ * with the functions of the joystick (play_move).
+ */
+static uint64_t game_perft(const QuoridorGame *game, int id_player, int depth) {
+	QuoridorGame next = *game;
+	MoveList list;
+	uint64_t nodes = 0;
+	int i;
+
+	if(depth == 0)
+		return 1;
+	if(board_winner(&next.board))
+		return 0;
+	game_moves(&next, id_player, &list);
+	if(!list.count)
+		return game_perft(&next, 3 - id_player, depth - 1);
+	if(depth == 1)
+		return list.count;
+	for(i = 0; i < list.count; i++) {
+		next = *game;
+		next.start_turn1 = id_player == 1;
+		next.start_turn2 = id_player == 2;
+		play_move(&next, list.move[i]);
+		nodes += game_perft(&next, 3 - id_player, depth - 1);
+	}
+	return nodes;
+}
+
+/* ***************   COMMANDS   *************** */
+
+/**
+ * @brief Counts of every depth, checked with the reference ones (and with the
+ * functions of the game, with -c).
+ *
+ * @return The number of mismatches.
+ */
+static int run_depths(QuoridorGame *game, int depth, int through_game) {
+	uint64_t nodes, other;
+	double start, seconds;
+	int d, errors = 0;
+
+	printf("%-6s %14s %10s %14s  %s\n", "depth", "positions", "seconds", "positions/s", "check");
+	for(d = 1; d <= depth; d++) {
+		start = now();
+		nodes = board_perft(&game->board, &game->paths, 1, d);
+		seconds = now() - start;
+		printf("%-6d %14llu %10.3f %14.0f  ", d, (unsigned long long) nodes, seconds, seconds > 0 ? nodes / seconds : 0);
+		if(d > REFERENCE_DEPTH)
+			printf("no reference");
+		else if(nodes == reference[d])
+			printf("reference ok");
+		else {
+			printf("REFERENCE %llu", (unsigned long long) reference[d]);
+			errors++;
+		}
+		if(through_game) {
+			start = now();
+			other = game_perft(game, 1, d);
+			if(other == nodes)
+				printf(", game ok (%.3f s)", now() - start);
+			else {
+				printf(", GAME %llu", (unsigned long long) other);
+				errors++;
+			}
+		}
+		printf("\n");
+	}
+	return errors;
+}
+
+/**
+ * @brief Positions under each move of player1 at the last depth.
+ *
+ * @return The number of moves whose count differs through the game (-c).
+ */
+static int run_divide(QuoridorGame *game, int depth, int through_game) {
+	QuoridorGame next;
+	MoveList list;
+	Undo u;
+	uint64_t nodes, other, total = 0;
+	char name[4];
+	int i, errors = 0;
+
+	board_gen_moves(&game->board, &game->paths, 1, &list);
+	printf("\ndepth %d, positions under each move:\n", depth);
+	for(i = 0; i < list.count; i++) {
+		make_move(&game->board, &game->paths, list.move[i], &u);
+		nodes = board_perft(&game->board, &game->paths, 2, depth - 1);
+		unmake_move(&game->board, &game->paths, &u);
+		total += nodes;
+		move_name(list.move[i], name);
+		printf("  %-4s %12llu", name, (unsigned long long) nodes);
+		if(through_game) {
+			next = *game;
+			next.start_turn1 = 1;
+			next.start_turn2 = 0;
+			play_move(&next, list.move[i]);
+			other = game_perft(&next, 2, depth - 1);
+			if(other != nodes) {
+				printf("  GAME %llu", (unsigned long long) other);
+				errors++;
+			}
+		}
+		printf("\n");
+	}
+	printf("  %-4s %12llu (%d moves)\n", "all", (unsigned long long) total, list.count);
+	return errors;
+}
+
+static int usage(void) {
+	fprintf(stderr, "usage: quoridor_perft [-d] [-c] [depth]\n");
+	return 2;
+}
+
+int main(int argc, char *argv[]) {
+	static QuoridorGame game;
+	int depth = DEFAULT_DEPTH, divide = 0, through_game = 0, errors, i;
+
+	for(i = 1; i < argc; i++)
+		if(!strcmp(argv[i], "-d"))
+			divide = 1;
+		else if(!strcmp(argv[i], "-c"))
+			through_game = 1;
+		else if(argv[i][0] != '-' && atoi(argv[i]) > 0)
+			depth = atoi(argv[i]);
+		else
+			return usage();
+	zobrist_init();
+	initialize_board(&game);
+	start_game(&game);
+	errors = run_depths(&game, depth, through_game);
+	if(divide)
+		errors += run_divide(&game, depth, through_game);
+	if(errors)
+		printf("%d mismatches\n", errors);
+	return errors != 0;
+}
@@ -0,0 +1,193 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "GLCD/GLCD.h"
+#include "c_functions.h"
+
+/* ***************   HOST BENCHMARK OF THE PONDERING   *************** */
+/* Usage: quoridor_ponder [-g games] [-b budget_ms] [-o think_ms] [-l slice_ms]
+		[-m tt_mb] [-s seed]
+	 The computer (computer_move, alpha-beta within 'budget_ms' on a table) plays
+	 matches against an opponent that takes 'think_ms' to answer (an alpha-beta
+	 at depth 2 after a pause, as a player at the joystick), first without and
+	 then with pondering: during the turn of the opponent a thread calls
+	 computer_ponder with slices of 'slice_ms', as the main loop does on the
+	 board between input events, until the move of the opponent (play_move) stops
+	 it. Every match starts with two random plies, the same in both runs. For
+	 each run: depth reached by the computer within its budget, hits of its
+	 table, depth reached by the pondering and score against the opponent. */
+
+#define MAX_PLIES 200
+#define OPENING_PLIES 2
+#define OPPONENT_DEPTH 2
+
+static QuoridorGame game;
+static Ponder ponder;
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint32_t clock_ms(void) {
+	return (uint32_t) (now() * 1000);
+}
+
+static void pause_ms(int ms) {
+	struct timespec ts;
+	ts.tv_sec = ms / 1000;
+	ts.tv_nsec = (long) (ms % 1000) * 1000000;
+	nanosleep(&ts, NULL);
+}
+
+static uint32_t next_random(uint64_t *state) {
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+	return (uint32_t) (*state >> 32);
+}
+
+typedef struct {
+	int games, wins, moves, depths, ponders, ponder_depths;
+	uint64_t probes, hits;
+	double seconds;
+} Result;
+
+static uint32_t slice_ms = 10;
+
+/**
+ * @brief Thread of the pondering: slices until the opponent moves (the main
+ * loop on the board, see input_drain).
+ */
+static void *ponder_main(void *arg) {
+	int *depth = arg;
+	int d;
+
+	while((d = computer_ponder(&game, slice_ms)) >= 0)
+		*depth = d;
+	return NULL;
+}
+
+static void play(QuoridorGame *g, Move m) {
+	g->start_turn1 = MOVE_PLAYER(m) == 1;
+	g->start_turn2 = MOVE_PLAYER(m) == 2;
+	play_move(g, m);
+}
+
+/**
+ * @brief One match, the computer with player 'computer'.
+ */
+static void run_game(Result *r, TransTable *tt, int computer, int pondering, uint32_t budget_ms,
+		int think_ms, uint64_t seed) {
+	MoveList list;
+	Search s;
+	pthread_t thread;
+	Move m;
+	uint32_t probes, hits;
+	int id_player = 1, ply, depth, started;
+
+	initialize_board(&game);
+	start_game(&game);
+	game.ponder = pondering ? &ponder : NULL;
+	ponder.abort = 1;
+	tt_clear(tt);
+	for(ply = 0; ply < MAX_PLIES && !board_winner(&game.board); ply++, id_player = 3 - id_player) {
+		if(ply < OPENING_PLIES) {
+			if(board_gen_moves(&game.board, &game.paths, id_player, &list))
+				play(&game, list.move[next_random(&seed) % list.count]);
+		} else if(id_player == computer) {
+			search_init(&s);
+			s.budget_ms = budget_ms;
+			s.clock_ms = clock_ms;
+			s.tt = tt;
+			probes = tt->probes;
+			hits = tt->hits;
+			game.start_turn1 = id_player == 1;
+			game.start_turn2 = id_player == 2;
+			computer_move(&game, id_player, &s);
+			r->moves++;
+			r->depths += s.depth;
+			r->probes += tt->probes - probes;
+			r->hits += tt->hits - hits;
+		} else {
+			depth = 0;
+			started = game.ponder && !game.ponder->abort && !pthread_create(&thread, NULL, ponder_main, &depth);
+			pause_ms(think_ms);
+			search_init(&s);
+			s.max_depth = OPPONENT_DEPTH;
+			m = search_best_move(&s, &game.board, &game.paths, id_player);
+			if(m != MOVE_NONE)
+				play(&game, m);		/* STOPS THE PONDERING */
+			else if(game.ponder)
+				game.ponder->abort = 1;
+			if(started) {
+				pthread_join(thread, NULL);
+				r->ponders++;
+				r->ponder_depths += depth;
+			}
+		}
+	}
+	r->games++;
+	r->wins += board_winner(&game.board) == computer;
+}
+
+static int usage(void) {
+	fprintf(stderr, "usage: quoridor_ponder [-g games] [-b budget_ms] [-o think_ms] [-l slice_ms]\n"
+		"                       [-m tt_mb] [-s seed]\n");
+	return 2;
+}
+
+int main(int argc, char *argv[]) {
+	int games = 10, budget_ms = 50, think_ms = 200, pondering, i;
+	double tt_mb = 16, start;
+	uint64_t seed = 88172645463325252ULL;
+	uint32_t entries;
+	TTSlot *buffer;
+	TransTable tt;
+	Result r;
+
+	for(i = 1; i < argc; i++) {
+		if(i + 1 >= argc || argv[i][0] != '-' || argv[i][2])
+			return usage();
+		switch(argv[i][1]) {
+			case 'g': games = atoi(argv[++i]); break;
+			case 'b': budget_ms = atoi(argv[++i]); break;
+			case 'o': think_ms = atoi(argv[++i]); break;
+			case 'l': slice_ms = (uint32_t) atoi(argv[++i]); break;
+			case 'm': tt_mb = atof(argv[++i]); break;
+			case 's': seed = strtoull(argv[++i], NULL, 0); break;
+			default: return usage();
+		}
+	}
+	if(games < 1 || budget_ms < 1 || think_ms < 0 || slice_ms < 1 || tt_mb <= 0)
+		return usage();
+	entries = (uint32_t) (tt_mb * 1024 * 1024 / sizeof(TTSlot));
+	buffer = malloc((size_t) (entries ? entries : 1) * sizeof(TTSlot));
+	if(!buffer)
+		return 1;
+	tt_init(&tt, buffer, entries ? entries : 1);
+	zobrist_init();
+
+	printf("%d games, budget %d ms, opponent %d ms, slices of %u ms, table %.0f MB\n",
+		games, budget_ms, think_ms, slice_ms, tt_mb);
+	printf("%-10s %12s %12s %14s %10s %10s\n", "pondering", "depth/move", "table hits", "ponder depth", "score", "seconds");
+	for(pondering = 0; pondering <= 1; pondering++) {
+		memset(&r, 0, sizeof(r));
+		start = now();
+		for(i = 0; i < games; i++)
+			run_game(&r, &tt, 1 + i % 2, pondering, (uint32_t) budget_ms, think_ms, seed + (uint64_t) (i / 2) * 0x9E3779B97F4A7C15ULL);
+		r.seconds = now() - start;
+		printf("%-10s %12.2f %11.1f%% ", pondering ? "on" : "off", r.moves ? (double) r.depths / r.moves : 0,
+			r.probes ? 100.0 * r.hits / r.probes : 0);
+		if(r.ponders)
+			printf("%14.2f", (double) r.ponder_depths / r.ponders);
+		else
+			printf("%14s", "-");
+		printf(" %9.1f%% %10.1f\n", 100.0 * r.wins / r.games, r.seconds);
+	}
+	free(buffer);
+	return 0;
+}
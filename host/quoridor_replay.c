@@ -0,0 +1,285 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "GLCD/GLCD.h"
+#ifdef FRAMEBUFFER
+#include "Render/Framebuffer.h"
+#endif
+#include "c_functions.h"
+#include "Input/Input.h"
+#include "Probe/Probe.h"
+
+/* ***************   HOST REPLAY OF RECORDED GAMES AND INPUTS   *************** */
+/* Usage: quoridor_replay [-u] [-n rounds] file...
+	 Every file is replayed through the functions of the game, as fast as the
+	 CPU allows: a game log (.log, the format of Engine/record.c) move by move
+	 with start_game and play_move (move_*_token, position_wall), a stream of
+	 input events (.ev, one byte per event, see Input/Input.h) through the ring
+	 and input_dispatch (joystick, buttons, turn timer). Nothing is drawn, or,
+	 built with FRAMEBUFFER (quoridor_replay_fb), everything is drawn into the
+	 off-screen framebuffer. At the end of each game a hash of its state
+	 (tokens, walls, walls left, winner, plies) is compared with the hashes
+	 next to the file (<file>.hashes, one per line; -u writes them again), so
+	 the corpus in replay/ checks a change of the engine or of the gaming
+	 functions. The replay is repeated 'rounds' times; the best time is shown.
+	 Built with PROBES (quoridor_replay_probe), the table of the cycle probes of
+	 the last round is printed after each file. */
+
+#define PATH_LENGTH 512
+#define MAX_GAMES 100000
+
+static QuoridorGame game;
+static uint64_t hashes[MAX_GAMES];
+static int games, plies, moves, rejected;	/* 'plies' OF THE OPEN GAME, 'moves' OF ALL */
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief FNV-1a of a value, chained to 'h'.
+ */
+static uint64_t hash_int(uint64_t h, int value) {
+	int i;
+
+	for(i = 0; i < 4; i++, value >>= 8) {
+		h ^= (uint8_t) value;
+		h *= 0x100000001B3ULL;
+	}
+	return h;
+}
+
+/**
+ * @brief Hash of the state of the match, from what the gaming functions keep
+ * (not the Zobrist keys, that change with the engine), appended to the list.
+ */
+static void end_game(void) {
+	uint64_t h = 0xCBF29CE484222325ULL;
+	Bits m;
+
+	h = hash_int(h, game.row_player1);
+	h = hash_int(h, game.col_player1);
+	h = hash_int(h, game.row_player2);
+	h = hash_int(h, game.col_player2);
+	h = hash_int(h, game.board.walls[0]);
+	h = hash_int(h, game.board.walls[1]);
+	for(m = game.board.wall_h; m; m &= m - 1)
+		h = hash_int(h, bit_scan(m));
+	h = hash_int(h, -1);
+	for(m = game.board.wall_v; m; m &= m - 1)
+		h = hash_int(h, bit_scan(m));
+	h = hash_int(h, board_winner(&game.board));
+	h = hash_int(h, plies);
+	if(games < MAX_GAMES)
+		hashes[games] = h;
+	games++;
+	moves += plies;
+	plies = 0;
+}
+
+/**
+ * @brief Replay of a game log: every move through play_move, with the turn of
+ * its player. A move that changes nothing, or a game that does not end with
+ * the winner of the log, is counted as rejected.
+ *
+ * @return 0, -1 for a byte that is not a code of the log.
+ */
+static int replay_log(const uint8_t *data, uint32_t length) {
+	LogReader r;
+	Move m;
+	uint64_t key;
+	int status, open = 0;
+
+	log_reader_init(&r, data, length);
+	while((status = log_read(&r, &m)) != LOG_READ_MORE) {
+		if(status == LOG_READ_BAD)
+			return -1;
+		if(status == LOG_READ_END) {
+			if(!open)
+				new_match(&game);
+			rejected += r.winner != board_winner(&game.board);
+			end_game();
+			open = 0;
+			continue;
+		}
+		if(!open) {
+			new_match(&game);
+			open = 1;
+		}
+		game.start_turn1 = MOVE_PLAYER(m) == 1;
+		game.start_turn2 = MOVE_PLAYER(m) == 2;
+		key = board_compute_key(&game.board);
+		play_move(&game, m);
+		game.end_turn1 = game.end_turn2 = 0;
+		rejected += board_compute_key(&game.board) == key;
+		plies++;
+	}
+	if(open)
+		end_game();		/* UNFINISHED */
+	return 0;
+}
+
+/**
+ * @brief Replay of a stream of input events: pushed into the ring as the
+ * interrupt handlers do (bursts of a full ring), then drained. A game ends
+ * with its winner; the touch that starts the next one opens it.
+ */
+static void replay_events(const uint8_t *data, uint32_t length) {
+	uint32_t i, j;
+	int event, started, turn;
+
+	game.start_match = 0;		/* THE FIRST TOUCH STARTS A MATCH (start_game RESETS THE TURNS) */
+	input_init(&input_queue);
+	for(i = 0; i < length; i += INPUT_QUEUE_SIZE) {
+		for(j = i; j < length && j < i + INPUT_QUEUE_SIZE; j++)
+			input_push(&input_queue, data[j]);
+		while((event = input_pop(&input_queue)) >= 0) {
+			started = game.start_match;
+			turn = game.start_turn1;
+			input_dispatch(&game, event);
+			if(!started)
+				continue;
+			plies += game.start_turn1 != turn || !game.start_match;	/* MOVE OR TIME OVER */
+			if(!game.start_match)
+				end_game();
+		}
+	}
+	if(game.start_match)
+		end_game();		/* UNFINISHED */
+}
+
+#ifdef PROBES
+static void print_line(const char *line) {
+	printf("  %s\n", line);
+}
+#endif
+
+static uint8_t *read_file(const char *path, uint32_t *length) {
+	FILE *f = fopen(path, "rb");
+	uint8_t *data;
+	long size;
+
+	if(!f)
+		return NULL;
+	fseek(f, 0, SEEK_END);
+	size = ftell(f);
+	rewind(f);
+	data = malloc(size > 0 ? (size_t) size : 1);
+	if(data && fread(data, 1, (size_t) size, f) != (size_t) size) {
+		free(data);
+		data = NULL;
+	}
+	fclose(f);
+	*length = (uint32_t) size;
+	return data;
+}
+
+/**
+ * @brief Hashes of the games against <path>.hashes (written with 'update').
+ *
+ * @return The number of games that differ, -1 without the file.
+ */
+static int check_hashes(const char *path, int update) {
+	char name[PATH_LENGTH];
+	unsigned long long h;
+	FILE *f;
+	int i, n = games < MAX_GAMES ? games : MAX_GAMES, differ = 0;
+
+	snprintf(name, sizeof(name), "%s.hashes", path);
+	if(update) {
+		if(!(f = fopen(name, "w")))
+			return -1;
+		for(i = 0; i < n; i++)
+			fprintf(f, "%016llx\n", (unsigned long long) hashes[i]);
+		fclose(f);
+		return 0;
+	}
+	if(!(f = fopen(name, "r")))
+		return -1;
+	for(i = 0; i < n; i++)
+		if(fscanf(f, "%llx", &h) != 1 || h != hashes[i]) {
+			if(differ++ < 5)
+				printf("  game %d: hash %016llx, expected %016llx\n", i + 1, (unsigned long long) hashes[i], h);
+		}
+	differ += fscanf(f, "%llx", &h) == 1;	/* MORE GAMES EXPECTED */
+	fclose(f);
+	return differ;
+}
+
+static int usage(void) {
+	fprintf(stderr, "usage: quoridor_replay [-u] [-n rounds] file...   (.log game log, .ev input events)\n");
+	return 2;
+}
+
+int main(int argc, char *argv[]) {
+	int rounds = 5, update = 0, failed = 0, i, round, events, differ;
+	double start, best;
+	const char *dot;
+	uint32_t length;
+	uint8_t *data;
+
+	for(i = 1; i < argc && argv[i][0] == '-'; i++) {
+		if(!strcmp(argv[i], "-u"))
+			update = 1;
+		else if(!strcmp(argv[i], "-n") && i + 1 < argc)
+			rounds = atoi(argv[++i]);
+		else
+			return usage();
+	}
+	if(i == argc || rounds < 1)
+		return usage();
+	zobrist_init();
+	probe_init();
+
+#if defined(PROBES)
+	printf("%-24s %8s %8s %10s %12s %12s  %s\n", "file (probes)", "games", "plies", "rejected", "games/s", "plies/s", "hashes");
+#elif defined(FRAMEBUFFER)
+	printf("%-24s %8s %8s %10s %12s %12s  %s\n", "file (framebuffer)", "games", "plies", "rejected", "games/s", "plies/s", "hashes");
+#else
+	printf("%-24s %8s %8s %10s %12s %12s  %s\n", "file", "games", "plies", "rejected", "games/s", "plies/s", "hashes");
+#endif
+	for(; i < argc; i++) {
+		if(!(data = read_file(argv[i], &length))) {
+			printf("%-24s cannot be read\n", argv[i]);
+			failed = 1;
+			continue;
+		}
+		dot = strrchr(argv[i], '.');
+		events = dot && !strcmp(dot, ".ev");
+		best = 0;
+		for(round = 0; round < rounds; round++) {
+			games = plies = moves = rejected = 0;
+			probe_reset();
+			start = now();
+			if(events)
+				replay_events(data, length);
+			else if(replay_log(data, length)) {
+				printf("%-24s not a game log\n", argv[i]);
+				failed = 1;
+				break;
+			}
+			start = now() - start;
+			if(!round || start < best)
+				best = start;
+		}
+		free(data);
+		if(round < rounds)
+			continue;
+		differ = check_hashes(argv[i], update);
+		printf("%-24s %8d %8d %10d %12.0f %12.0f  ", argv[i], games, moves, rejected, games / best, moves / best);
+		if(update)
+			printf("%s\n", differ ? "NOT WRITTEN" : "written");
+		else if(differ < 0)
+			printf("missing\n");
+		else if(differ)
+			printf("%d DIFFER\n", differ);
+		else
+			printf("ok\n");
+		failed |= differ != 0;
+		probe_dump(print_line);
+	}
+	return failed;
+}
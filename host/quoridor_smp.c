@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Engine/Engine.h"
+#include "smp_search.h"
+
+/* ***************   HOST BENCHMARK OF THE PARALLEL SEARCH   *************** */
+/* Usage: quoridor_smp [-t threads] [-d depth] [-b budget_ms] [-p positions]
+		[-m tt_mb] [-s seed]
+	 For 1, 2, 4, ... 'threads' threads, a pool of smp_search.c searches the same
+	 positions (the start and positions after a few random plies): first to a
+	 fixed depth (time to depth, speed-up on one thread, positions per second of
+	 all the threads), then within a fixed budget of time per move (depth reached,
+	 which is what an analysis request gets, and the slowest answer). The table
+	 is emptied before every search, so the searches do not help each other. */
+
+#define MAX_POSITIONS 256
+#define RANDOM_PLIES 8			/* PLIES OF THE RANDOM POSITIONS (AT MOST) */
+
+typedef struct {
+	Board board;
+	PathCache paths;
+	int id_player;
+} Position;
+
+static Position positions[MAX_POSITIONS];
+static int position_count = 16;
+static uint64_t seed = 2463534242u;
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint32_t clock_ms(void) {
+	return (uint32_t) (now() * 1000);
+}
+
+static uint32_t next_random(void) {
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return (uint32_t) (seed >> 32);
+}
+
+/**
+ * @brief The start, then positions after 1 to RANDOM_PLIES random moves (matches not over).
+ */
+static void make_positions(void) {
+	MoveList list;
+	Position *p;
+	int i, ply, plies;
+
+	for(i = 0; i < position_count; i++) {
+		p = &positions[i];
+		board_init(&p->board);
+		board_start(&p->board);
+		path_cache_init(&p->paths, &p->board);
+		p->id_player = 1;
+		plies = i ? 1 + next_random() % RANDOM_PLIES : 0;
+		for(ply = 0; ply < plies && !board_winner(&p->board); ply++) {
+			if(board_gen_moves(&p->board, &p->paths, p->id_player, &list))
+				board_play(&p->board, &p->paths, list.move[next_random() % list.count]);
+			p->id_player = 3 - p->id_player;
+		}
+		if(board_winner(&p->board))
+			i--;		/* ANOTHER ONE */
+	}
+}
+
+/**
+ * @brief All the positions searched by a pool, to a fixed depth or within a budget.
+ */
+static void run(SmpPool *pool, int depth, uint32_t budget_ms, double *seconds, uint64_t *nodes,
+		double *average_depth, double *slowest) {
+	Search s;
+	uint64_t n;
+	double start, t;
+	int i, depths = 0;
+
+	*seconds = *slowest = 0;
+	*nodes = 0;
+	for(i = 0; i < position_count; i++) {
+		smp_clear(pool);
+		search_init(&s);
+		s.max_depth = depth;
+		s.budget_ms = budget_ms;
+		s.clock_ms = clock_ms;
+		start = now();
+		smp_best_move(pool, &s, &positions[i].board, &positions[i].paths, positions[i].id_player, &n);
+		t = now() - start;
+		*seconds += t;
+		if(t > *slowest)
+			*slowest = t;
+		*nodes += n;
+		depths += s.depth;
+	}
+	*average_depth = (double) depths / position_count;
+}
+
+static int usage(void) {
+	fprintf(stderr, "usage: quoridor_smp [-t threads] [-d depth] [-b budget_ms] [-p positions]\n"
+		"                    [-m tt_mb] [-s seed]\n");
+	return 2;
+}
+
+int main(int argc, char *argv[]) {
+	int threads = 4, depth = 5, budget_ms = 100, t, i;
+	double tt_mb = 64, seconds, slowest, average_depth, base = 0;
+	uint32_t entries;
+	uint64_t nodes;
+	TTSlot *buffer;
+	SmpPool *pool;
+
+	for(i = 1; i < argc; i++) {
+		if(i + 1 >= argc || argv[i][0] != '-' || argv[i][2])
+			return usage();
+		switch(argv[i][1]) {
+			case 't': threads = atoi(argv[++i]); break;
+			case 'd': depth = atoi(argv[++i]); break;
+			case 'b': budget_ms = atoi(argv[++i]); break;
+			case 'p': position_count = atoi(argv[++i]); break;
+			case 'm': tt_mb = atof(argv[++i]); break;
+			case 's': seed = strtoull(argv[++i], NULL, 0); break;
+			default: return usage();
+		}
+	}
+	if(threads < 1 || depth < 1 || depth > SEARCH_MAX_DEPTH || budget_ms < 1
+			|| position_count < 1 || position_count > MAX_POSITIONS || tt_mb <= 0)
+		return usage();
+	entries = (uint32_t) (tt_mb * 1024 * 1024 / sizeof(TTSlot));
+	buffer = malloc((size_t) (entries ? entries : 1) * sizeof(TTSlot));
+	if(!buffer)
+		return 1;
+	zobrist_init();
+	make_positions();
+
+	printf("%d positions, depth %d, budget %d ms, table %.0f MB\n", position_count, depth, budget_ms, tt_mb);
+	printf("%-8s %14s %9s %14s   %12s %14s\n", "threads", "time to depth", "speed-up", "nodes/s",
+		"depth in time", "slowest answer");
+	for(t = 1; ; t = t * 2 > threads && t < threads ? threads : t * 2) {
+		pool = smp_create(t, buffer, entries ? entries : 1);
+		if(!pool || smp_threads(pool) != t) {
+			fprintf(stderr, "cannot start %d threads\n", t);
+			return 1;
+		}
+		run(pool, depth, 0, &seconds, &nodes, &average_depth, &slowest);
+		if(t == 1)
+			base = seconds;
+		printf("%-8d %11.1f ms %8.2fx %14.0f", t, seconds * 1000 / position_count, base / seconds, nodes / seconds);
+		run(pool, SEARCH_MAX_DEPTH, (uint32_t) budget_ms, &seconds, &nodes, &average_depth, &slowest);
+		printf("   %12.2f %11.1f ms\n", average_depth, slowest * 1000);
+		smp_destroy(pool);
+		if(t >= threads)
+			break;
+	}
+	free(buffer);
+	return 0;
+}
@@ -0,0 +1,434 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include "c_functions.h"
+
+/* ***************   HOST SELF-PLAY TOURNAMENT   *************** */
+/* Usage: quoridor_tournament [-n games] [-t threads] [-a engine] [-b engine]
+		[-o plies] [-m tt_mb] [-s seed] [-c 1] [-w min_score]
+	 Engines: random, greedy, abN (alpha-beta, depth N), abN:MS (and a budget of
+	 MS milliseconds per move), mctsN (Monte Carlo tree search, N playouts),
+	 mctsN:MS (and a budget of MS milliseconds per move). Engine A plays player1 in the even games and
+	 player2 in the odd ones; the first 'plies' moves of every game are random,
+	 so that deterministic engines do not repeat the same game. The rules are
+	 those of the board (Engine/: the generator behind possible_moves,
+	 is_overlapped_wall and is_trappola, face-to-face jumps included). With -c 1
+	 every wall played is also checked with is_overlapped_wall and is_trappola
+	 of c_functions.c, on a match of the thread. With -w the exit status is 1
+	 if the score of A is below 'min_score' percent (make strength).
+
+	 Games are spread on a pool of threads with work stealing: each thread owns
+	 a range of games, takes them from the front, and when its range is empty
+	 takes half of the range left to another thread. Each game has its own seed
+	 and each thread its own transposition table, cleared before every game, so
+	 the results do not depend on the number of threads (unless a time budget
+	 is given). */
+
+#define MAX_THREADS 256
+#define MAX_PLIES 400				/* LONGER GAMES ARE DRAWS */
+#define GREEDY_MARGIN 1			/* STEPS THE OPPONENT MUST BE AHEAD FOR A WALL */
+#define MCTS_NODES (1 << 20)	/* ARENA OF THE MONTE CARLO ENGINE, FOR EACH THREAD */
+
+enum { ENGINE_RANDOM, ENGINE_GREEDY, ENGINE_ALPHABETA, ENGINE_MCTS };
+
+typedef struct {
+	int type;
+	int depth;							/* OR PLAYOUTS */
+	uint32_t budget_ms;
+	char name[32];
+} Engine;
+
+typedef struct {
+	int8_t winner_a;		/* 1 ENGINE A WON, 0 ENGINE B WON, -1 DRAW */
+	uint16_t plies;
+	uint64_t nodes;
+} GameResult;
+
+typedef struct {
+	pthread_t thread;
+	pthread_mutex_t lock;
+	long next, end;			/* GAMES STILL TO PLAY: [next, end) */
+	long played, stolen;
+	TransTable tt;
+	TTSlot *tt_buffer;
+	MctsNode *arena;		/* FOR THE MONTE CARLO ENGINE */
+	QuoridorGame *game;	/* FOR THE CHECK OF THE WALLS (-c) */
+	long rule_errors;
+	int index;
+} Worker;
+
+static Engine engines[2];
+static GameResult *results;
+static Worker workers[MAX_THREADS];
+static int threads = 1, opening_plies = 4, check_rules;
+static uint32_t tt_entries;
+static uint64_t seed = 1;
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint32_t clock_ms(void) {
+	return (uint32_t) (now() * 1000);
+}
+
+/**
+ * @brief Pseudo-random number (xorshift64*), one state for each game.
+ */
+static uint32_t next_random(uint64_t *state) {
+	*state ^= *state >> 12;
+	*state ^= *state << 25;
+	*state ^= *state >> 27;
+	return (uint32_t) ((*state * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+static int parse_engine(Engine *e, const char *spec) {
+	char *end;
+
+	memset(e, 0, sizeof(*e));
+	snprintf(e->name, sizeof(e->name), "%s", spec);
+	if(!strcmp(spec, "random"))
+		e->type = ENGINE_RANDOM;
+	else if(!strcmp(spec, "greedy"))
+		e->type = ENGINE_GREEDY;
+	else if(!strncmp(spec, "ab", 2)) {
+		e->type = ENGINE_ALPHABETA;
+		e->depth = (int) strtol(spec + 2, &end, 10);
+		if(*end == ':')
+			e->budget_ms = (uint32_t) strtoul(end + 1, &end, 10);
+		if(*end || e->depth < 1 || e->depth > SEARCH_MAX_DEPTH)
+			return 0;
+	} else if(!strncmp(spec, "mcts", 4)) {
+		e->type = ENGINE_MCTS;
+		e->depth = (int) strtol(spec + 4, &end, 10);
+		if(*end == ':')
+			e->budget_ms = (uint32_t) strtoul(end + 1, &end, 10);
+		if(*end || e->depth < 1)
+			return 0;
+	} else
+		return 0;
+	return 1;
+}
+
+/* ***************   ENGINES   *************** */
+
+/**
+ * @brief Greedy engine: a step along the shortest path, or the wall that
+ * lengthens the path of the opponent the most when it is ahead by at least
+ * GREEDY_MARGIN steps. Ties are broken at random.
+ */
+static Move greedy_move(Board *b, PathCache *pc, int id_player, uint64_t *state) {
+	MoveList list;
+	Undo undo;
+	Move best = MOVE_NONE;
+	int me = id_player - 1, i, score, best_score = -1000, ties = 0;
+	int walls = b->walls[me] && pc->length[1 - me] + GREEDY_MARGIN <= pc->length[me];
+
+	if(!board_gen_moves(b, pc, id_player, &list))
+		return MOVE_NONE;
+	for(i = 0; i < list.count; i++) {
+		if(MOVE_IS_WALL(list.move[i]) && !walls)
+			continue;
+		make_move(b, pc, list.move[i], &undo);
+		score = pc->length[1 - me] - pc->length[me];
+		unmake_move(b, pc, &undo);
+		if(score > best_score) {
+			best_score = score;
+			best = list.move[i];
+			ties = 1;
+		} else if(score == best_score && next_random(state) % ++ties == 0)
+			best = list.move[i];
+	}
+	return best;
+}
+
+static Move engine_move(const Engine *e, Worker *w, Board *b, PathCache *pc, int id_player, uint64_t *state, uint64_t *nodes) {
+	MoveList list;
+	Search s;
+	Mcts mcts;
+	Move m;
+
+	switch(e->type) {
+		case ENGINE_GREEDY:
+			return greedy_move(b, pc, id_player, state);
+		case ENGINE_ALPHABETA:
+			search_init(&s);
+			s.max_depth = e->depth;
+			s.budget_ms = e->budget_ms;
+			s.clock_ms = clock_ms;
+			s.tt = tt_entries ? &w->tt : NULL;
+			m = search_best_move(&s, b, pc, id_player);
+			*nodes += s.nodes;
+			return m;
+		case ENGINE_MCTS:
+			mcts_init(&mcts, w->arena, MCTS_NODES);
+			mcts.playouts = (uint32_t) e->depth;
+			mcts.budget_ms = e->budget_ms;
+			mcts.clock_ms = clock_ms;
+			mcts.seed = next_random(state) | 1;
+			m = mcts_best_move(&mcts, b, pc, id_player);
+			*nodes += mcts.done;
+			return m;
+		default:
+			if(!board_gen_moves(b, pc, id_player, &list))
+				return MOVE_NONE;
+			return list.move[next_random(state) % list.count];
+	}
+}
+
+/**
+ * @brief A wall of the generator must be accepted by the functions of the
+ * joystick: no overlap (is_overlapped_wall), no player trapped (is_trappola).
+ */
+static int wall_refused(QuoridorGame *game, const Board *b, const PathCache *pc, Move m) {
+	int sq = MOVE_SQUARE(m);
+
+	game->board = *b;
+	game->paths = *pc;
+	game->horizontal = MOVE_HORIZONTAL(m);
+	game->vertical = !game->horizontal;
+	game->posx_wall = COL_OF(sq) - game->horizontal;		/* AS IN play_move */
+	game->posy_wall = ROW_OF(sq) - game->vertical;
+	return is_overlapped_wall(game, game->posx_wall, game->posy_wall)
+		|| is_trappola(game, 1, game->posx_wall, game->posy_wall)
+		|| is_trappola(game, 2, game->posx_wall, game->posy_wall);
+}
+
+/**
+ * @brief One game of the tournament.
+ */
+static void play_game(Worker *w, long game) {
+	Board b;
+	PathCache pc;
+	MoveList list;
+	Move m;
+	uint64_t state = seed ^ (uint64_t) (game + 1) * 0x9E3779B97F4A7C15ULL, nodes = 0;
+	int ply, id_player = 1, a_player = game % 2 ? 2 : 1, winner;
+
+	if(!state)
+		state = 1;
+	if(tt_entries)
+		tt_clear(&w->tt);
+	board_init(&b);
+	board_start(&b);
+	path_cache_init(&pc, &b);
+	for(ply = 0; ply < MAX_PLIES && !board_winner(&b); ply++, id_player = 3 - id_player) {
+		if(ply < opening_plies) {
+			m = board_gen_moves(&b, &pc, id_player, &list) ? list.move[next_random(&state) % list.count] : MOVE_NONE;
+		} else
+			m = engine_move(&engines[id_player == a_player ? 0 : 1], w, &b, &pc, id_player, &state, &nodes);
+		if(check_rules && m != MOVE_NONE && MOVE_IS_WALL(m))
+			w->rule_errors += wall_refused(w->game, &b, &pc, m);
+		if(m != MOVE_NONE)
+			board_play(&b, &pc, m);		/* NONE: NO LEGAL MOVE, THE PLAYER PASSES */
+	}
+	winner = board_winner(&b);
+	results[game].winner_a = (int8_t) (winner ? winner == a_player : -1);
+	results[game].plies = (uint16_t) ply;
+	results[game].nodes = nodes;
+}
+
+/* ***************   WORK-STEALING POOL   *************** */
+
+/**
+ * @brief Next game of a worker: the first of its range, or else the second
+ * half of the largest range left to another worker (the game itself when a
+ * single one is left).
+ *
+ * @return The game, -1 when all games are taken.
+ */
+static long take_game(Worker *w) {
+	Worker *victim;
+	long game = -1, left, most, first = 0, end = 0;
+	int i, k;
+
+	pthread_mutex_lock(&w->lock);
+	if(w->next < w->end)
+		game = w->next++;
+	pthread_mutex_unlock(&w->lock);
+	while(game < 0) {
+		/* #1 THE VICTIM: THE WORKER WITH THE MOST GAMES LEFT */
+		victim = NULL;
+		most = 0;
+		for(k = 1; k < threads; k++) {
+			i = (w->index + k) % threads;
+			pthread_mutex_lock(&workers[i].lock);
+			left = workers[i].end - workers[i].next;
+			pthread_mutex_unlock(&workers[i].lock);
+			if(left > most) {
+				most = left;
+				victim = &workers[i];
+			}
+		}
+		if(!victim)
+			return -1;
+		/* #2 ITS RANGE IS SPLIT UNDER ITS LOCK ONLY (THE RANGE OF THE THIEF IS
+			 EMPTY, NOBODY STEALS FROM IT), THEN BECOMES THE RANGE OF THE THIEF */
+		pthread_mutex_lock(&victim->lock);
+		left = victim->end - victim->next;
+		if(left > 0) {
+			end = victim->end;
+			first = end - (left + 1) / 2;
+			victim->end = first;
+		}
+		pthread_mutex_unlock(&victim->lock);
+		if(left > 0) {
+			pthread_mutex_lock(&w->lock);
+			w->next = first + 1;
+			w->end = end;
+			w->stolen += end - first;
+			pthread_mutex_unlock(&w->lock);
+			game = first;
+		}
+	}
+	return game;
+}
+
+static void *worker_main(void *arg) {
+	Worker *w = arg;
+	long game;
+
+	while((game = take_game(w)) >= 0) {
+		play_game(w, game);
+		w->played++;
+	}
+	return NULL;
+}
+
+/* ***************   REPORT   *************** */
+
+static double report(long games, double seconds) {
+	long g, wins = 0, losses = 0, draws = 0, plies = 0;
+	uint64_t nodes = 0;
+	double score, var = 0, margin, x, elo;
+	int t;
+
+	for(g = 0; g < games; g++) {
+		wins += results[g].winner_a == 1;
+		losses += results[g].winner_a == 0;
+		draws += results[g].winner_a < 0;
+		plies += results[g].plies;
+		nodes += results[g].nodes;
+	}
+	/* SCORE OF A (WIN 1, DRAW 1/2) AND 95% INTERVAL FROM THE VARIANCE OF THE GAMES */
+	score = (wins + draws / 2.0) / games;
+	for(g = 0; g < games; g++) {
+		x = results[g].winner_a < 0 ? 0.5 : results[g].winner_a;
+		var += (x - score) * (x - score);
+	}
+	margin = games > 1 ? 1.96 * sqrt(var / (games - 1) / games) : 0;
+	printf("%s vs %s: %ld games, %d threads, %d random opening plies\n",
+		engines[0].name, engines[1].name, games, threads, opening_plies);
+	printf("%-24s %10.1f games/s %14.0f nodes/s (%.2f s)\n", "throughput", games / seconds, nodes / seconds, seconds);
+	printf("%-24s %9.1f%% +- %.1f%% (wins %ld, losses %ld, draws %ld)\n", "score of A", 100 * score, 100 * margin, wins, losses, draws);
+	if(score > 0 && score < 1) {
+		elo = -400 * log10(1 / score - 1);
+		printf("%-24s %10.0f [%.0f, %.0f]\n", "elo difference", elo,
+			score - margin > 0 ? -400 * log10(1 / (score - margin) - 1) : -INFINITY,
+			score + margin < 1 ? -400 * log10(1 / (score + margin) - 1) : INFINITY);
+	}
+	printf("%-24s %10.1f plies/game\n", "length", (double) plies / games);
+	if(check_rules) {
+		for(t = 0, g = 0; t < threads; t++)
+			g += workers[t].rule_errors;
+		printf("%-24s %10ld walls refused by is_overlapped_wall/is_trappola\n", "rules", g);
+	}
+	for(t = 0; t < threads; t++)
+		printf("  thread %-3d %10ld games %8ld stolen\n", t, workers[t].played, workers[t].stolen);
+	return score;
+}
+
+static int usage(void) {
+	fprintf(stderr, "usage: quoridor_tournament [-n games] [-t threads] [-a engine] [-b engine]\n"
+		"                          [-o plies] [-m tt_mb] [-s seed] [-c 1] [-w min_score]\n"
+		"engines: random, greedy, abN (depth N), abN:MS (and MS ms per move),\n"
+		"         mctsN (N playouts), mctsN:MS (and MS ms per move)\n");
+	return 2;
+}
+
+int main(int argc, char *argv[]) {
+	long games = 1000, per, g;
+	double tt_mb = 1, min_score = 0, start, score;
+	int i, t;
+
+	parse_engine(&engines[0], "ab2");
+	parse_engine(&engines[1], "greedy");
+	for(i = 1; i < argc; i++) {
+		if(i + 1 >= argc || argv[i][0] != '-' || argv[i][2])
+			return usage();
+		switch(argv[i][1]) {
+			case 'n': games = atol(argv[++i]); break;
+			case 't': threads = atoi(argv[++i]); break;
+			case 'o': opening_plies = atoi(argv[++i]); break;
+			case 'm': tt_mb = atof(argv[++i]); break;
+			case 's': seed = strtoull(argv[++i], NULL, 0); break;
+			case 'c': check_rules = atoi(argv[++i]); break;
+			case 'w': min_score = atof(argv[++i]); break;
+			case 'a':
+			case 'b':
+				if(!parse_engine(&engines[argv[i][1] - 'a'], argv[i + 1])) {
+					fprintf(stderr, "%s: unknown engine\n", argv[i + 1]);
+					return usage();
+				}
+				i++;
+				break;
+			default: return usage();
+		}
+	}
+	if(games < 1 || threads < 1 || threads > MAX_THREADS)
+		return usage();
+	results = calloc(games, sizeof(GameResult));
+	if(!results)
+		return 1;
+	zobrist_init();		/* BEFORE THE THREADS */
+	tt_entries = (uint32_t) (tt_mb * 1024 * 1024 / sizeof(TTSlot));
+	/* EQUAL RANGES TO START WITH */
+	per = games / threads;
+	for(t = 0, g = 0; t < threads; t++) {
+		Worker *w = &workers[t];
+		w->index = t;
+		w->next = g;
+		w->end = g = t == threads - 1 ? games : g + per;
+		w->played = w->stolen = w->rule_errors = 0;
+		pthread_mutex_init(&w->lock, NULL);
+		if(check_rules) {
+			w->game = calloc(1, sizeof(QuoridorGame));
+			if(!w->game)
+				return 1;
+		}
+		if(engines[0].type == ENGINE_MCTS || engines[1].type == ENGINE_MCTS) {
+			w->arena = malloc((size_t) MCTS_NODES * sizeof(MctsNode));
+			if(!w->arena)
+				return 1;
+		}
+		if(tt_entries) {
+			w->tt_buffer = malloc((size_t) tt_entries * sizeof(TTSlot));
+			if(!w->tt_buffer)
+				return 1;
+			tt_init(&w->tt, w->tt_buffer, tt_entries);
+		}
+	}
+	start = now();
+	for(t = 0; t < threads; t++)
+		if(pthread_create(&workers[t].thread, NULL, worker_main, &workers[t]))
+			return 1;
+	for(t = 0; t < threads; t++)
+		pthread_join(workers[t].thread, NULL);
+	score = report(games, now() - start);
+	for(t = 0; t < threads; t++) {
+		free(workers[t].tt_buffer);
+		free(workers[t].arena);
+		free(workers[t].game);
+	}
+	free(results);
+	if(100 * score < min_score) {
+		printf("score of A below %.1f%%\n", min_score);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,185 @@
+#include <stdlib.h>
+#include <pthread.h>
+#include "smp_search.h"
+
+/* ***************   PARALLEL SEARCH ON THE HOST (LAZY SMP)   *************** */
+/* The threads of a pool search the same position with search_best_move, on one
+	 transposition table shared without locks (see TTSlot): what a thread finds
+	 is read by the others from the table. The calling thread is the main one,
+	 with the limits of the caller, and its result is the result of the search;
+	 the helpers (threads - 1, started once with the pool and then waiting) start
+	 one depth ahead or with the root moves in another order, and are aborted
+	 as soon as the main thread is done. */
+
+typedef struct {
+	pthread_t thread;
+	SmpPool *pool;
+	Search search;
+	TransTable tt;
+	int index;
+} Helper;
+
+struct SmpPool {
+	pthread_mutex_t lock;
+	pthread_cond_t start, done;
+	TransTable tt;								/* OWNER OF THE SLOTS, USED BY THE MAIN THREAD */
+	Helper *helpers;
+	int count;										/* HELPERS */
+	/* JOB OF THE HELPERS, UNDER 'lock' */
+	const Board *board;
+	const PathCache *paths;
+	int id_player, max_depth;
+	unsigned long job;						/* COUNTER OF THE SEARCHES */
+	int running, quit;
+	volatile int abort;
+};
+
+static void *helper_main(void *arg) {
+	Helper *h = arg;
+	SmpPool *pool = h->pool;
+	unsigned long job = 0;
+
+	pthread_mutex_lock(&pool->lock);
+	for(;;) {
+		while(pool->job == job && !pool->quit)
+			pthread_cond_wait(&pool->start, &pool->lock);
+		if(pool->quit)
+			break;
+		job = pool->job;
+		pthread_mutex_unlock(&pool->lock);
+		h->search.max_depth = pool->max_depth;
+		search_best_move(&h->search, pool->board, pool->paths, pool->id_player);
+		pthread_mutex_lock(&pool->lock);
+		if(--pool->running == 0)
+			pthread_cond_signal(&pool->done);
+	}
+	pthread_mutex_unlock(&pool->lock);
+	return NULL;
+}
+
+/**
+ * @brief Pool of threads for the parallel search, on a table supplied by the
+ * caller (as tt_init). zobrist_init must have been called.
+ *
+ * @param threads  The number of threads, the calling one included (at least 1).
+ * @param buffer  The memory of the shared table.
+ * @param entries  The number of entries of the buffer.
+ *
+ * @return The pool, NULL if it could not be created.
+ */
+SmpPool *smp_create(int threads, TTSlot *buffer, uint32_t entries) {
+	SmpPool *pool = calloc(1, sizeof(SmpPool));
+	int i;
+
+	if(!pool)
+		return NULL;
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->start, NULL);
+	pthread_cond_init(&pool->done, NULL);
+	tt_init(&pool->tt, buffer, entries);
+	pool->helpers = calloc(threads > 1 ? threads - 1 : 1, sizeof(Helper));
+	if(!pool->helpers) {
+		free(pool);
+		return NULL;
+	}
+	for(i = 0; i < threads - 1; i++) {
+		Helper *h = &pool->helpers[i];
+		h->pool = pool;
+		h->index = i + 1;
+		search_init(&h->search);
+		h->search.tt = &h->tt;
+		h->search.abort = &pool->abort;
+		h->search.helper = h->index;
+		if(pthread_create(&h->thread, NULL, helper_main, h))
+			break;
+		pool->count++;
+	}
+	return pool;
+}
+
+/**
+ * @brief Stop the threads of a pool and free it (not the table).
+ *
+ * @return Nothing
+ */
+void smp_destroy(SmpPool *pool) {
+	int i;
+
+	pthread_mutex_lock(&pool->lock);
+	pool->quit = 1;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->lock);
+	for(i = 0; i < pool->count; i++)
+		pthread_join(pool->helpers[i].thread, NULL);
+	pthread_mutex_destroy(&pool->lock);
+	pthread_cond_destroy(&pool->start);
+	pthread_cond_destroy(&pool->done);
+	free(pool->helpers);
+	free(pool);
+}
+
+/**
+ * @brief Number of threads of a pool, the calling one included.
+ */
+int smp_threads(const SmpPool *pool) {
+	return pool->count + 1;
+}
+
+/**
+ * @brief Empty the shared table (e.g. before an unrelated position).
+ *
+ * @return Nothing
+ */
+void smp_clear(SmpPool *pool) {
+	tt_clear(&pool->tt);
+}
+
+/**
+ * @brief Best move of a player, searched by all the threads of the pool.
+ *
+ * @details Same limits and results of search_best_move ('tt' is replaced by
+ * the table of the pool), so the depth reached within 'budget_ms' grows with
+ * the threads. Must not be called by two threads at the same time.
+ *
+ * @param pool  The pool.
+ * @param s  The search of the main thread, with its limits and results.
+ * @param b  The board (not modified).
+ * @param pc  The cache of the shortest paths, up to date with the board (not modified).
+ * @param id_player  The player to move (1 or 2).
+ * @param nodes  If not NULL, the positions visited by all the threads.
+ *
+ * @return The best move, MOVE_NONE if the player has no legal move or the match is over.
+ */
+Move smp_best_move(SmpPool *pool, Search *s, const Board *b, const PathCache *pc, int id_player, uint64_t *nodes) {
+	Move best;
+	int i;
+
+	/* #1 SAME GENERATION ON EVERY TABLE: EACH SEARCH STARTS WITH tt_new_search */
+	for(i = 0; i < pool->count; i++)
+		tt_share(&pool->helpers[i].tt, &pool->tt);
+	s->tt = &pool->tt;
+	/* #2 HELPERS ON THE SAME POSITION, THEN THE MAIN THREAD */
+	pthread_mutex_lock(&pool->lock);
+	pool->board = b;
+	pool->paths = pc;
+	pool->id_player = id_player;
+	pool->max_depth = s->max_depth;
+	pool->abort = 0;
+	pool->running = pool->count;
+	pool->job++;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->lock);
+	best = search_best_move(s, b, pc, id_player);
+	/* #3 THE HELPERS ARE STOPPED: THEIR RESULTS ARE IN THE TABLE */
+	pthread_mutex_lock(&pool->lock);
+	__atomic_store_n(&pool->abort, 1, __ATOMIC_RELAXED);
+	while(pool->running)
+		pthread_cond_wait(&pool->done, &pool->lock);
+	pthread_mutex_unlock(&pool->lock);
+	if(nodes) {
+		*nodes = s->nodes;
+		for(i = 0; i < pool->count; i++)
+			*nodes += pool->helpers[i].search.nodes;
+	}
+	return best;
+}
@@ -0,0 +1,16 @@
+#ifndef __SMP_SEARCH_H
+#define __SMP_SEARCH_H
+
+#include "Engine/Engine.h"
+
+/* ***************   PARALLEL SEARCH ON THE HOST (LAZY SMP)   *************** */
+
+typedef struct SmpPool SmpPool;
+
+SmpPool *smp_create(int threads, TTSlot *buffer, uint32_t entries);
+void smp_destroy(SmpPool *pool);
+int smp_threads(const SmpPool *pool);
+void smp_clear(SmpPool *pool);
+Move smp_best_move(SmpPool *pool, Search *s, const Board *b, const PathCache *pc, int id_player, uint64_t *nodes);
+
+#endif